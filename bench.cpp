@@ -0,0 +1,406 @@
+﻿#include "json.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <sys/resource.h>
+using namespace std;
+
+//メモリ確保の計測(-Wl,--wrap=malloc,--wrap=free,--wrap=calloc,--wrap=realloc でリンク)
+static size_t b_allocs = 0, b_frees = 0, b_alloc_bytes = 0, b_live = 0, b_peak = 0;
+extern "C" {
+void* __real_malloc(size_t size);
+void __real_free(void* p);
+void* __real_calloc(size_t num, size_t size);
+void* __real_realloc(void* p, size_t size);
+
+static void bench_count_alloc(void* p) {
+	if (p == nullptr) return;
+	size_t size = malloc_usable_size(p);
+	++b_allocs;
+	b_alloc_bytes += size;
+	b_live += size;
+	if (b_live > b_peak) b_peak = b_live;
+}
+static void bench_count_free(void* p) {
+	if (p == nullptr) return;
+	++b_frees;
+	b_live -= malloc_usable_size(p);
+}
+void* __wrap_malloc(size_t size) {
+	void* p = __real_malloc(size);
+	bench_count_alloc(p);
+	return p;
+}
+void __wrap_free(void* p) {
+	bench_count_free(p);
+	__real_free(p);
+}
+void* __wrap_calloc(size_t num, size_t size) {
+	void* p = __real_calloc(num, size);
+	bench_count_alloc(p);
+	return p;
+}
+void* __wrap_realloc(void* p, size_t size) {
+	bench_count_free(p);
+	void* r = __real_realloc(p, size);
+	bench_count_alloc(r != nullptr ? r : (size != 0 ? p : nullptr));
+	return r;
+}
+}
+
+//計測区間のメモリ確保
+struct bench_allocs {
+	size_t allocs, frees, bytes, live, peak;
+	void start() {
+		allocs = b_allocs; frees = b_frees; bytes = b_alloc_bytes; live = b_live;
+		b_peak = b_live;
+	}
+	void stop() {
+		allocs = b_allocs - allocs; frees = b_frees - frees; bytes = b_alloc_bytes - bytes;
+		peak = b_peak - live;
+	}
+};
+
+//再現性のある乱数(xorshift64*)
+struct bench_rng {
+	uint64_t s;
+	explicit bench_rng(const uint64_t seed) : s(seed) {}
+	uint64_t next() {
+		s ^= s >> 12; s ^= s << 25; s ^= s >> 27;
+		return s * 2685821657736338717ULL;
+	}
+	size_t range(const size_t n) { return (size_t)(next() % n); }
+	double real() { return (double)(next() >> 11) / 9007199254740992.0; }
+};
+
+static const char* const b_words[] = {
+	"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel", "india", "juliet",
+	"kilo", "lima", "mike", "november", "oscar", "papa", "quebec", "romeo", "sierra", "tango",
+};
+static void bench_words(string& out, bench_rng& r, const size_t n) {
+	for (size_t i = 0; i < n; ++i) {
+		if (i != 0) out += ' ';
+		out += b_words[r.range(20)];
+	}
+}
+static void bench_number(string& out, bench_rng& r) {
+	char buf[32];
+	switch (r.range(4)) {
+		case 0: snprintf(buf, sizeof(buf), "%d", (int)r.range(1000)); break;
+		case 1: snprintf(buf, sizeof(buf), "%lld", (long long)(r.next() >> 1) * (r.range(2) ? 1 : -1)); break;
+		case 2: snprintf(buf, sizeof(buf), "%.17g", (r.real() - 0.5) * 1e6); break;
+		default: snprintf(buf, sizeof(buf), "%.6g", r.real() * 100); break;
+	}
+	out += buf;
+}
+
+//コーパスの生成(sizeバイト程度の圧縮形式のJSON)
+static string bench_numbers(const size_t size) {
+	bench_rng r(1);
+	string out = "[";
+	while (out.size() < size) {
+		if (out.size() > 1) out += ',';
+		bench_number(out, r);
+	}
+	return out + "]";
+}
+static string bench_logs(const size_t size) {
+	bench_rng r(2);
+	string out = "[";
+	char buf[64];
+	for (size_t i = 0; out.size() < size; ++i) {
+		if (i != 0) out += ',';
+		snprintf(buf, sizeof(buf), "{\"ts\":\"2024-05-%02d T%02d:%02d:%02d.%03dZ\",\"level\":\"", (int)r.range(28) + 1, (int)r.range(24), (int)r.range(60), (int)r.range(60), (int)r.range(1000));
+		out += buf;
+		static const char* const levels[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+		out += levels[r.range(4)];
+		out += "\",\"msg\":\"";
+		bench_words(out, r, 8 + r.range(24));
+		if (r.range(4) == 0) out += " \\\"quoted\\\" path C:\\\\tmp\\\\log\\n\\tcaf\\u00e9";
+		snprintf(buf, sizeof(buf), "\",\"host\":\"web-%02d\",\"request_id\":\"%016llx\",\"tags\":[\"", (int)r.range(64), (unsigned long long)r.next());
+		out += buf;
+		out += b_words[r.range(20)];
+		out += "\",\"";
+		out += b_words[r.range(20)];
+		out += "\"]}";
+	}
+	return out + "]";
+}
+static string bench_nested(const size_t size) {
+	bench_rng r(3);
+	string out = "[";
+	vector<bool> arrays;
+	for (size_t i = 0; out.size() < size; ++i) {
+		if (i != 0) out += ',';
+		//64〜255段のオブジェクト(一部は要素1個の配列で包む)
+		arrays.resize(64 + r.range(192));
+		for (size_t d = 0; d < arrays.size(); ++d) {
+			out += "{\"";
+			out += b_words[r.range(20)];
+			out += "\":";
+			arrays[d] = r.range(4) == 0;
+			if (arrays[d]) out += '[';
+		}
+		bench_number(out, r);
+		for (size_t d = arrays.size(); d-- > 0; ) out += arrays[d] ? "]}" : "}";
+	}
+	return out + "]";
+}
+static string bench_wide(const size_t size) {
+	bench_rng r(4);
+	string out = "{";
+	char buf[32];
+	for (size_t i = 0; out.size() < size; ++i) {
+		if (i != 0) out += ',';
+		snprintf(buf, sizeof(buf), "\"field_%07u\":", (unsigned)i);
+		out += buf;
+		switch (i % 3) {
+			case 0: bench_number(out, r); break;
+			case 1: out += '"'; bench_words(out, r, 2); out += '"'; break;
+			default: out += r.range(2) ? "true" : "false"; break;
+		}
+	}
+	return out + "}";
+}
+//twitter.jsonに近い構造
+static string bench_twitter(const size_t size) {
+	bench_rng r(5);
+	string out = "{\"statuses\":[";
+	char buf[256];
+	for (size_t i = 0; out.size() < size; ++i) {
+		if (i != 0) out += ',';
+		unsigned long long id = 505874924095815681ULL + r.range(1 << 30);
+		snprintf(buf, sizeof(buf), "{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"ja\"},\"created_at\":\"Sun Aug 31 00:29:%02d +0000 2014\",\"id\":%llu,\"id_str\":\"%llu\",\"text\":\"", (int)r.range(60), id, id);
+		out += buf;
+		bench_words(out, r, 4 + r.range(16));
+		out += " \\u3042\\u3044\\u3046\",\"source\":\"<a href=\\\"http://twitter.com/download/iphone\\\" rel=\\\"nofollow\\\">Twitter for iPhone</a>\",\"truncated\":false,";
+		snprintf(buf, sizeof(buf), "\"in_reply_to_status_id\":null,\"user\":{\"id\":%u,\"id_str\":\"%u\",\"name\":\"", (unsigned)r.next(), (unsigned)r.next());
+		out += buf;
+		bench_words(out, r, 2);
+		snprintf(buf, sizeof(buf), "\",\"screen_name\":\"%s_%u\",\"location\":\"\",\"followers_count\":%u,\"friends_count\":%u,\"verified\":%s,\"profile_background_color\":\"C0DEED\",\"default_profile\":true},",
+			b_words[r.range(20)], (unsigned)r.range(10000), (unsigned)r.range(100000), (unsigned)r.range(5000), r.range(8) == 0 ? "true" : "false");
+		out += buf;
+		out += "\"geo\":null,\"coordinates\":null,\"place\":null,\"contributors\":null,";
+		snprintf(buf, sizeof(buf), "\"retweet_count\":%u,\"favorite_count\":%u,\"entities\":{\"hashtags\":[", (unsigned)r.range(1000), (unsigned)r.range(1000));
+		out += buf;
+		for (size_t h = 0, hn = r.range(3); h < hn; ++h) {
+			if (h != 0) out += ',';
+			snprintf(buf, sizeof(buf), "{\"text\":\"%s\",\"indices\":[%u,%u]}", b_words[r.range(20)], (unsigned)h * 10, (unsigned)h * 10 + 8);
+			out += buf;
+		}
+		out += "],\"symbols\":[],\"urls\":[],\"user_mentions\":[]},\"favorited\":false,\"retweeted\":false,\"lang\":\"ja\"}";
+	}
+	return out + "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"query\":\"%E4%B8%80\",\"count\":100,\"since_id\":0}}";
+}
+//citm_catalog.jsonに近い構造
+static string bench_citm(const size_t size) {
+	bench_rng r(6);
+	string events = "{\"events\":{", perf;
+	char buf[256];
+	for (size_t i = 0; events.size() + perf.size() < size; ++i) {
+		unsigned id = 138586341 + (unsigned)i;
+		if (i != 0) { events += ','; perf += ','; }
+		snprintf(buf, sizeof(buf), "\"%u\":{\"description\":null,\"id\":%u,\"logo\":%s,\"name\":\"", id, id, r.range(2) ? "null" : "\"/images/UE0AAAAACEKo6QAAAAZDSVRN\"");
+		events += buf;
+		bench_words(events, r, 3);
+		events += "\",\"subTopicIds\":[337184269,337184283],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[324846099,107888604]}";
+		snprintf(buf, sizeof(buf), "{\"eventId\":%u,\"id\":%u,\"logo\":null,\"name\":null,\"prices\":[", id, 339887544 + (unsigned)i);
+		perf += buf;
+		for (size_t p = 0, pn = 1 + r.range(4); p < pn; ++p) {
+			if (p != 0) perf += ',';
+			snprintf(buf, sizeof(buf), "{\"amount\":%u,\"audienceSubCategoryId\":337100890,\"seatCategoryId\":%u}", (unsigned)(r.range(200) + 10) * 950, 338937295 + (unsigned)p);
+			perf += buf;
+		}
+		snprintf(buf, sizeof(buf), "],\"seatCategories\":[{\"areas\":[{\"areaId\":205705999,\"blockIds\":[]}],\"seatCategoryId\":338937295}],\"seatMapImage\":null,\"start\":%llu,\"venueCode\":\"PLEYEL_PLEYEL\"}", 1372701600000ULL + r.range(1000) * 86400000ULL);
+		perf += buf;
+	}
+	return events + "},\"performances\":[" + perf + "]}";
+}
+
+//計測結果
+struct bench_result {
+	string corpus, variant, op;
+	size_t bytes, ops;
+	double ns;
+	bench_allocs a;
+};
+static string b_label;
+static bool b_failed = false; //読み込み・検索の失敗(終了コードで返す)
+
+static void bench_report(const bench_result& b) {
+	//1行1件のJSONで出力
+	double ns_per_op = b.ns / (double)b.ops;
+	double mbps = b.bytes != 0 ? (double)b.bytes / (b.ns / 1e9) / 1e6 : 0;
+	printf("{\"label\":\"%s\",\"corpus\":\"%s\",\"variant\":\"%s\",\"op\":\"%s\",\"bytes\":%zu,\"ops\":%zu,\"ns_per_op\":%.1f,\"mb_per_s\":%.2f,\"allocs\":%zu,\"frees\":%zu,\"alloc_bytes\":%zu,\"peak_heap\":%zu}\n",
+		b_label.c_str(), b.corpus.c_str(), b.variant.c_str(), b.op.c_str(), b.bytes, b.ops, ns_per_op, mbps, b.a.allocs, b.a.frees, b.a.bytes, b.a.peak);
+	fprintf(stderr, "%-8s %-9s %-10s %10.2f MB/s %12.1f ns/op %10zu allocs %12zu peak\n",
+		b.corpus.c_str(), b.variant.c_str(), b.op.c_str(), mbps, ns_per_op, b.a.allocs, b.a.peak);
+	fflush(stdout);
+}
+
+static double bench_now() {
+	return (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//検索・編集の対象(親ノードとキーまたは添字)
+struct bench_target {
+	json_node<>* parent;
+	string key;
+	size_t index;
+};
+static void bench_collect(json_node<>* n, vector<bench_target>& out, bench_rng& r, const size_t limit) {
+	json_type t = n->type();
+	if (t != Object && t != Array) return;
+	for (size_t i = 0, size = n->size(); i < size; ++i) {
+		json_node<>* c = n->_child(i);
+		if (c == nullptr) continue;
+		bench_target b;
+		b.parent = n;
+		b.index = i;
+		if (t == Object) b.key.assign(n->_child_key(i)->data, n->_child_key(i)->len);
+		//上限を超えたら置き換え(リザーバサンプリング)
+		if (out.size() < limit) out.push_back(b);
+		else {
+			size_t j = r.range(out.size() * 2);
+			if (j < limit) out[j] = b;
+		}
+		bench_collect(c, out, r, limit);
+	}
+}
+
+static void bench_run(const string& corpus, const string& variant, const string& text, const int repeat) {
+	bench_result b;
+	b.corpus = corpus;
+	b.variant = variant;
+	json_node<>* root = nullptr;
+
+	//読み込み(最速の回を採用、メモリ確保は最後の回)
+	b.op = "parse"; b.bytes = text.size(); b.ops = 1; b.ns = 1e30;
+	for (int i = 0; i < repeat; ++i) {
+		delete root;
+		b.a.start();
+		double t = bench_now();
+		root = json_parse(text);
+		t = bench_now() - t;
+		b.a.stop();
+		if (t < b.ns) b.ns = t;
+	}
+	if (root == nullptr) { fprintf(stderr, "%s %s: parse failed\n", corpus.c_str(), variant.c_str()); b_failed = true; return; }
+	bench_report(b);
+
+	//書き出し(インデントあり・なし)
+	for (int compact = 0; compact < 2; ++compact) {
+		b.op = compact ? "print_compact" : "print_indent"; b.ns = 1e30;
+		for (int i = 0; i < repeat; ++i) {
+			b.a.start();
+			double t = bench_now();
+			string out = compact ? root->print(-1, "") : root->print(1, "\t");
+			t = bench_now() - t;
+			b.a.stop();
+			b.bytes = out.size();
+			if (t < b.ns) b.ns = t;
+		}
+		bench_report(b);
+	}
+
+	//ランダムな要素の検索
+	bench_rng r(7);
+	vector<bench_target> targets;
+	bench_collect(root, targets, r, 65536);
+	if (!targets.empty()) {
+		b.op = "lookup"; b.bytes = 0; b.ops = 200000; b.ns = 1e30;
+		for (int i = 0; i < repeat; ++i) {
+			size_t found = 0;
+			b.a.start();
+			double t = bench_now();
+			for (size_t j = 0; j < b.ops; ++j) {
+				const bench_target& g = targets[r.range(targets.size())];
+				found += (g.parent->type() == Array ? g.parent->get_array(g.index) : g.parent->get_object(g.key)) != nullptr;
+			}
+			t = bench_now() - t;
+			b.a.stop();
+			if (found != b.ops) { fprintf(stderr, "%s %s: lookup missed\n", corpus.c_str(), variant.c_str()); b_failed = true; }
+			if (t < b.ns) b.ns = t;
+		}
+		bench_report(b);
+
+		//ランダムな要素の置き換え(数値・文字列のみ)
+		vector<bench_target> leaves;
+		for (size_t j = 0; j < targets.size(); ++j) {
+			json_node<>* c = targets[j].parent->_child(targets[j].index);
+			if (c != nullptr && (c->type() == Number || c->type() == String)) leaves.push_back(targets[j]);
+		}
+		if (!leaves.empty()) {
+			b.op = "mutate"; b.ops = 100000; b.ns = 1e30;
+			const string mutated = "mutated";
+			for (int i = 0; i < repeat; ++i) {
+				b.a.start();
+				double t = bench_now();
+				for (size_t j = 0; j < b.ops; ++j) {
+					const bench_target& g = leaves[r.range(leaves.size())];
+					json_node<>* n;
+					if (j & 1) n = new json_number<>((int64_t)j);
+					else n = new json_string<>(mutated);
+					if (g.parent->type() == Array) g.parent->set_array(g.index, n);
+					else g.parent->set_object(g.key, n);
+				}
+				t = bench_now() - t;
+				b.a.stop();
+				if (t < b.ns) b.ns = t;
+			}
+			bench_report(b);
+		}
+	}
+
+	//破棄
+	b.op = "teardown"; b.bytes = text.size(); b.ops = 1;
+	b.a.start();
+	double t = bench_now();
+	delete root;
+	b.ns = bench_now() - t;
+	b.a.stop();
+	bench_report(b);
+}
+
+int main(int argc, char* argv[]) {
+	//bench [-s 生成サイズ(MB)] [-r 繰り返し回数] [-l ラベル] [-c コーパス名]
+	double scale = 4;
+	int repeat = 5;
+	string only;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "-s") == 0) scale = atof(argv[i + 1]);
+		else if (strcmp(argv[i], "-r") == 0) repeat = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "-l") == 0) _json_escape_encode(argv[i + 1], strlen(argv[i + 1]), b_label);
+		else if (strcmp(argv[i], "-c") == 0) only = argv[i + 1];
+		else { fprintf(stderr, "usage: %s [-s MB] [-r repeat] [-l label] [-c corpus]\n", argv[0]); return 1; }
+	}
+	if (repeat < 1) repeat = 1;
+	size_t size = (size_t)(scale * 1024 * 1024);
+
+	struct { const char* name; string (*make)(size_t); } corpora[] = {
+		{ "numbers", bench_numbers }, { "logs", bench_logs }, { "nested", bench_nested },
+		{ "wide", bench_wide }, { "twitter", bench_twitter }, { "citm", bench_citm },
+	};
+	for (size_t i = 0; i < sizeof(corpora) / sizeof(corpora[0]); ++i) {
+		if (!only.empty() && only != corpora[i].name) continue;
+		string minified = corpora[i].make(size);
+		bench_run(corpora[i].name, "minified", minified, repeat);
+		//整形済みの入力
+		json_node<>* n = json_parse(minified);
+		if (n == nullptr) { b_failed = true; continue; }
+		string pretty = n->print(1, "  ");
+		delete n;
+		bench_run(corpora[i].name, "pretty", pretty, repeat);
+	}
+
+	struct rusage u;
+	getrusage(RUSAGE_SELF, &u);
+	printf("{\"label\":\"%s\",\"op\":\"process\",\"max_rss_kb\":%ld}\n", b_label.c_str(), (long)u.ru_maxrss);
+	fprintf(stderr, "max rss %ld KB\n", (long)u.ru_maxrss);
+	return b_failed ? 1 : 0;
+}
@@ -0,0 +1,1807 @@
+﻿#include "json.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+//json.hppの動作確認(make check)
+//./Check [差分テストの回数]
+
+static int g_checks = 0, g_failed = 0;
+#define CHECK(x) do { ++g_checks; if (!(x)) { ++g_failed; printf("%s:%d: CHECK(%s)\n", __FILE__, __LINE__, #x); } } while (0)
+
+//operator newの呼び出し回数(取得でメモリを確保しないことの確認用)
+//解放をインライン展開するとGCCがfreeとoperator newの組を誤検知するため展開しない
+static atomic<size_t> g_news(0);
+void* operator new(size_t size) {
+	g_news.fetch_add(1, memory_order_relaxed);
+	if (void* p = malloc(size != 0 ? size : 1)) return p;
+	throw bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+
+//決定的な乱数(xorshift)
+struct check_rng {
+	uint64_t s;
+	check_rng(const uint64_t seed) : s(seed) {}
+	uint64_t next() { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+	size_t below(const size_t n) { return n == 0 ? 0 : (size_t)(next() % n); }
+};
+
+static string print_or_null(json_node<>* n) {
+	if (n == nullptr) return "(null)";
+	string s = n->print(0);
+	delete n;
+	return s;
+}
+
+//差分テスト
+//変異させた入力を各読み込み方法に与え、受理・拒否と出力が一致することを確認する
+static const char* const check_seeds[] = {
+	"{\"a\":1,\"b\":[true,false,null],\"c\":{\"d\":\"e\"}}",
+	"[1,-2,3.5,-0.25,1e10,1E-5,123456789012345678,-9223372036854775808,18446744073709551615]",
+	"{\"s\":\"\\u003c\\u00e9\\ud83d\\ude00\\n\\t\\\\\\\"/\",\"t\":\"\xE3\x81\x82\"}",
+	"[[],{},[[]],{\"\":{}},[{},[]]]",
+	"  {\n\t\"k\" : [ 1 , 2 ] ,\r\n \"k\" : \"dup\" }  ",
+	"\"plain\"",
+	"0",
+	"-1.5e-300",
+	"true",
+	"null",
+	"[0.1,0.2,0.30000000000000004,5e-324,1.7976931348623157e308]",
+	"{\"nested\":{\"a\":{\"b\":{\"c\":[1,[2,[3,[4]]]]}}}}",
+};
+
+static string mutate(check_rng& r, string s) {
+	static const char alphabet[] = "{}[]\",:0123456789-+.eEtrufalsn \\/u\t\n";
+	const size_t ops = 1 + r.below(3);
+	for (size_t k = 0; k < ops; ++k) {
+		const size_t pos = r.below(s.size() + 1);
+		switch (r.below(6)) {
+			case 0: if (pos < s.size()) s[pos] = alphabet[r.below(sizeof(alphabet) - 1)]; break;
+			case 1: s.insert(pos, 1, alphabet[r.below(sizeof(alphabet) - 1)]); break;
+			case 2: if (pos < s.size()) s.erase(pos, 1 + r.below(4)); break;
+			case 3: s = s.substr(0, pos); break;
+			case 4: { //一部を複製
+				const size_t len = r.below(s.size() - pos + 1);
+				s.insert(r.below(s.size() + 1), s.substr(pos, len));
+				break;
+			}
+			case 5: if (pos < s.size()) s[pos] = (char)r.below(256); break;
+		}
+	}
+	return s;
+}
+
+static bool push_parse(check_rng& r, const string& s, string& out) {
+	//ランダムな長さに分割して入力
+	json_push_parser p;
+	for (size_t i = 0; i < s.size(); ) {
+		size_t len = 1 + r.below(r.below(2) ? 4 : 64);
+		if (len > s.size() - i) len = s.size() - i;
+		if (!p.feed(s.data() + i, len)) return false;
+		i += len;
+	}
+	if (!p.finish() || p.available() != 1) return false;
+	out = print_or_null(p.next());
+	return true;
+}
+
+static void check_accepted(check_rng& r, const string& s, const string& expect) {
+	//受理された入力はすべての読み込み方法で同じ結果になる
+	CHECK(print_or_null(json_parse(s)) == expect);
+	json_value v;
+	CHECK(json_value::parse(s, v) && v.print(0) == expect);
+	json_tape t;
+	CHECK(t.parse(s) && print_or_null(t.root().to_node()) == expect);
+	json_document doc;
+	json_node<>* lazy = doc.parse_lazy(s);
+	CHECK(lazy != nullptr && lazy->print(0) == expect);
+	json_document pdoc;
+	lazy = pdoc.parse_lazy(s); //読み込み前のコンテナを複数スレッドで出力
+	CHECK(lazy != nullptr && lazy->print_parallel(0, "", 2) == expect);
+	string pushed;
+	CHECK(push_parse(r, s, pushed) && pushed == expect);
+
+	//出力・複製・変換の結果も一致する
+	json_node<>* n = json_parse(expect);
+	CHECK(n != nullptr);
+	if (n == nullptr) return;
+	CHECK(n->print(0) == expect);
+	CHECK(n->print_cached(0) == expect && n->print_cached(0) == expect);
+	CHECK(n->print_parallel(0, "", 2) == expect);
+	CHECK(print_or_null(n->clone()) == expect);
+	CHECK(json_value(n).print(0) == expect);
+	CHECK(print_or_null(json_from_cbor(json_to_cbor(n))) == expect);
+	CHECK(print_or_null(json_from_msgpack(json_to_msgpack(n))) == expect);
+	delete n;
+}
+
+static void test_differential(const size_t iterations) {
+	check_rng r(0x9E3779B97F4A7C15ULL);
+	json_parser parser;
+	size_t accepted = 0;
+	for (size_t i = 0; i < iterations; ++i) {
+		const string seed = check_seeds[r.below(sizeof(check_seeds) / sizeof(check_seeds[0]))];
+		const string s = i < sizeof(check_seeds) / sizeof(check_seeds[0]) ? string(check_seeds[i]) : mutate(r, seed);
+		json_parse_result res = parser.parse(s);
+		string pushed;
+		const bool push_ok = push_parse(r, s, pushed);
+		CHECK(bool(res) == push_ok);
+		if (res) {
+			++accepted;
+			check_accepted(r, s, print_or_null(res.node));
+		} else {
+			//末尾以外のエラーは寛容な読み込み方法でも拒否される
+			CHECK(res.node == nullptr);
+			if (res.error != json_error_trailing) {
+				CHECK(json_parse(s) == nullptr);
+				json_value v;
+				CHECK(!json_value::parse(s, v));
+			}
+		}
+		if (g_failed > 0) { printf("differential: input %zu: %s\n", i, s.c_str()); return; }
+	}
+	CHECK(accepted > iterations / 20);
+}
+
+static string nested(const size_t depth) { return string(depth, '[') + string(depth, ']'); }
+
+//分割入力の深さの上限
+static void test_push_depth() {
+	const string deep = nested(2000000);
+	json_push_parser p;
+	CHECK(!p.feed(deep));
+	CHECK(p.error() && p.error_code() == json_error_depth && p.error_offset() == json_default_max_depth);
+	CHECK(!p.finish() && p.next() == nullptr);
+
+	json_push_parser q(nullptr, nullptr, 4);
+	CHECK(q.feed(nested(4)) && q.finish() && q.available() == 1);
+	delete q.next();
+	CHECK(!q.feed(nested(5)) && q.error_code() == json_error_depth);
+	q.reset();
+	q.set_max_depth(5);
+	CHECK(q.feed(nested(5)) && q.finish() && q.error_code() == json_error_none);
+	CHECK(!q.feed("[1,]") && q.error_code() == json_error_syntax);
+}
+
+//分割された入力の読み込み
+static string push_values(const string& s, const size_t split) {
+	//splitの位置で2つに分けて入力し、取り出した値を連結
+	json_push_parser p;
+	if (!p.feed(s.data(), split) || !p.feed(s.data() + split, s.size() - split) || !p.finish()) return "(error)";
+	string out;
+	while (json_node<>* n = p.next()) out += print_or_null(n) + " ";
+	return out;
+}
+
+static void test_push_chunks() {
+	//文字列・エスケープ・数値・リテラルの途中を含むすべての位置で分割
+	const string doc = "{\"k\\u00e9y\":\"a\\\"b\\\\\\ud83d\\ude00\",\"n\":[-12.5e+3,0,18446744073709551615,true,false,null]} [] 42 \"s\" -0.5";
+	const string expect = "{\"k\xC3\xA9y\":\"a\\\"b\\\\\xF0\x9F\x98\x80\",\"n\":[-12500.0,0,18446744073709551615,true,false,null]} [] 42 \"s\" -0.5 ";
+	for (size_t split = 0; split <= doc.size(); ++split) CHECK(push_values(doc, split) == expect);
+
+	//1バイトずつ入力すると完成した値から順に取り出せる
+	json_push_parser p;
+	size_t completed = 0;
+	for (size_t i = 0; i < doc.size(); ++i) {
+		CHECK(p.feed(doc.data() + i, 1));
+		while (json_node<>* n = p.next()) { ++completed; delete n; }
+		if (i + 1 == doc.find(" []")) CHECK(completed == 1);
+	}
+	CHECK(completed == 4);
+	//最後の数値はfinishで確定する
+	CHECK(p.finish() && p.available() == 1 && print_or_null(p.next()) == "-0.5");
+
+	//エラー位置は入力全体での位置
+	json_push_parser e;
+	CHECK(e.feed("[1, 2") && !e.feed(", x]") && e.error() && e.error_offset() == 7 && e.error_code() == json_error_syntax);
+	CHECK(!e.feed("1") && e.next() == nullptr);
+	e.reset();
+	CHECK(e.feed("\"ab") && !e.finish() && e.feed("c\"") && e.finish() && print_or_null(e.next()) == "\"abc\"");
+	e.reset();
+	CHECK(e.feed("\"\\u12") && !e.feed("G4\"") && e.error_offset() == 5 && e.error_code() == json_error_string);
+	e.reset();
+	CHECK(e.feed("[\"a\x01") == false && e.error_offset() == 3 && e.error_code() == json_error_string);
+	e.reset();
+	CHECK(e.feed("[1,-") && !e.feed("]") && e.error_offset() == 3 && e.error_code() == json_error_number);
+	e.reset();
+	CHECK(e.feed("0") && e.feed("1") && !e.finish() && e.error_offset() == 0 && e.error_code() == json_error_number);
+
+	//先頭のBOMは分割されていても読み飛ばす(先頭以外・途中までのBOMはエラー)
+	const string bom = "\xEF\xBB\xBF";
+	for (size_t split = 0; split <= 5; ++split) CHECK(push_values(bom + "[1]", split) == "[1] ");
+	e.reset();
+	CHECK(!e.feed("\xEF\xBB[1]") && e.error_offset() == 0 && e.error_code() == json_error_syntax);
+	e.reset();
+	CHECK(e.feed("\xEF\xBB") && !e.finish());
+	e.reset();
+	CHECK(!e.feed("1 " + bom) && e.error_offset() == 2);
+	e.reset();
+	CHECK(!e.feed("[" + bom + "]") && e.error_offset() == 1);
+	//数値・リテラルの後には空白か構造文字が必要
+	const char* adjacent[] = { "true1", "nulltrue", "1true", "false0", "1\"a\"" };
+	for (const char* a : adjacent) {
+		json_push_parser q;
+		CHECK(!(q.feed(a) && q.finish()) && q.error_code() == json_error_syntax);
+	}
+	CHECK(push_values("true 1", 3) == "true 1 " && push_values("1[2]", 1) == "1 [2] " && push_values("null{}\"a\"1", 4) == "null {} \"a\" 1 ");
+	e.reset();
+	CHECK(e.feed("tru") && e.feed("e") && !e.feed("1") && e.error_offset() == 4 && e.available() == 1);
+}
+
+//テープの深さの上限
+static void test_tape_depth() {
+	json_tape t;
+	CHECK(!t.parse(nested(2000000)) && t.empty());
+	CHECK(!t.parse(nested(json_default_max_depth + 1)));
+	CHECK(t.parse(nested(json_default_max_depth)) && print_or_null(t.root().to_node()) == nested(json_default_max_depth));
+	json_tape small(3);
+	CHECK(small.parse(nested(3)) && !small.parse(nested(4)));
+	small.set_max_depth(4);
+	CHECK(small.parse("{\"a\":[{\"b\":[]}]}") && print_or_null(small.root().to_node()) == "{\"a\":[{\"b\":[]}]}");
+}
+
+//構造インデックスの単純な実装(正しいJSONのみ)
+static vector<uint32_t> reference_index(const string& s) {
+	vector<uint32_t> out;
+	bool in = false, escape = false, scalar = false;
+	for (size_t i = 0; i < s.size(); ++i) {
+		const char c = s[i];
+		if (in) {
+			if (escape) escape = false;
+			else if (c == '\\') escape = true;
+			else if (c == '\"') in = false;
+			continue;
+		}
+		if (c == '\"') { out.push_back((uint32_t)i); in = true; scalar = false; }
+		else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') { out.push_back((uint32_t)i); scalar = false; }
+		else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') scalar = false;
+		else { if (!scalar) out.push_back((uint32_t)i); scalar = true; }
+	}
+	return out;
+}
+
+//SIMDの各段階と単純な実装の結果が一致する(ブロック境界をまたぐ文字列・エスケープを含む)
+static void test_structural_index() {
+	check_rng r(12345);
+	static const char alphabet[] = "\"\\{}[]:, \t\nab01-";
+	vector<uint32_t> expect, got;
+	for (int i = 0; i < 20000; ++i) {
+		string s(r.below(300), ' ');
+		for (char& c : s) c = alphabet[r.below(sizeof(alphabet) - 1)];
+		const bool ok = json_structural_index(s, expect, 0);
+		for (int level = 1; level <= json_simd_level(); ++level) CHECK(json_structural_index(s, got, level) == ok && got == expect);
+	}
+	for (const char* seed : check_seeds) {
+		//長い文字列でブロック境界をまたがせる
+		for (size_t pad = 0; pad < 130; pad += 7) {
+			const string s = "[\"" + string(pad, '\\').substr(0, pad & ~(size_t)1) + string(pad, 'x') + "\"," + seed + "]";
+			for (int level = 0; level <= json_simd_level(); ++level) CHECK(json_structural_index(s, got, level) && got == reference_index(s));
+		}
+	}
+}
+
+//構造インデックスは32bitの位置に収まる入力のみ受け付ける
+static void test_index_limit() {
+	vector<uint32_t> index;
+	const string json = "{\"a\":[1,\"b\"]}";
+	CHECK(json_structural_index(json, index) && index.size() == 9);
+	//4GiBを超える長さは読み込む前に拒否する
+	CHECK(!json_structural_index(json.data(), (size_t)UINT32_MAX + 1, index) && index.empty());
+}
+
+//存在しない要素はキーの型によらず共有されたnullになる
+static void test_missing_element() {
+	json_node<>* root = json_parse("{\"a\":{\"b\":1},\"s\":\"str\",\"l\":[0]}");
+	json_node<>& null = json_node<>::null_node();
+	CHECK((*root)["a"]["b"].get_int() == 1);
+	CHECK(&(*root)["missing"] == &null && &(*root)["missing"]["b"] == &null);
+	CHECK(&(*root)[string("missing")]["b"] == &null);
+	CHECK(&(*root)[json_key("missing")] == &null);
+	CHECK(&(*root)["a"]["missing"] == &null && &(*root)["l"][1] == &null && &(*root)["s"]["b"] == &null);
+	const char* key = "a";
+	CHECK(&(*root)[key] == root->get_object("a") && &(*root)["a"] == root->get_object(string("a")));
+	CHECK(null.type() == Null && null.print(0) == "null");
+	null.set_string("x");
+	CHECK(null.emplace_object<json_null<>>("k") == nullptr);
+	CHECK(null.type() == Null && null.size() == 0);
+	delete root;
+}
+
+//構造体との変換は型に収まらない数値を拒否する
+struct check_numbers { uint8_t a; int b; int64_t c; uint64_t d; float e; double f; };
+JSON_BIND(check_numbers, a, b, c, d, e, f)
+
+static void test_bind_range() {
+	check_numbers v = check_numbers();
+	CHECK(json_parse_into("{\"a\":255,\"b\":-2147483648,\"c\":-9223372036854775808,\"d\":18446744073709551615,\"e\":1.5,\"f\":1e300}", v));
+	CHECK(v.a == 255 && v.b == INT32_MIN && v.c == INT64_MIN && v.d == UINT64_MAX && v.e == 1.5f && v.f == 1e300);
+	CHECK(json_parse_into("{\"b\":2e3,\"d\":1e19}", v) && v.b == 2000 && v.d == 10000000000000000000ULL);
+	CHECK(!json_parse_into("{\"a\":300}", v));
+	CHECK(!json_parse_into("{\"a\":-1}", v));
+	CHECK(!json_parse_into("{\"b\":3.7}", v));
+	CHECK(!json_parse_into("{\"b\":1e30}", v));
+	CHECK(!json_parse_into("{\"b\":2147483648}", v));
+	CHECK(!json_parse_into("{\"c\":9223372036854775808}", v));
+	CHECK(!json_parse_into("{\"d\":-1}", v));
+	CHECK(!json_parse_into("{\"d\":1.5}", v));
+	CHECK(!json_parse_into("{\"e\":1e39}", v));
+	CHECK(json_parse_into<vector<uint8_t>>("[1,256]").empty());
+}
+
+//再帰する構造体は読み込みで入れ子の深さを制限する
+struct check_tree { int v; vector<check_tree> kids; };
+JSON_BIND(check_tree, v, kids)
+
+static string tree_text(const size_t levels, const bool leaf_kids) {
+	//各段が{"kids":[...]}の2段になる
+	string s;
+	for (size_t i = 1; i < levels; ++i) s += "{\"kids\":[";
+	s += leaf_kids ? "{\"kids\":[]}" : "{}";
+	for (size_t i = 1; i < levels; ++i) s += "]}";
+	return s;
+}
+
+static void test_bind_depth() {
+	const size_t max = json_default_max_depth;
+	check_tree t;
+	CHECK(json_parse_into(tree_text(max / 2, true), t) && !t.kids.empty()); //上限ちょうど
+	CHECK(!json_parse_into(tree_text(max / 2 + 1, false), t));
+	CHECK(!json_parse_into(string(200000, '['), t) && !json_parse_into(tree_text(100000, true), t));
+	CHECK(json_parse_into("{\"v\":1,\"kids\":[{\"v\":2},null,{\"kids\":[{\"v\":3}]}]}", t) && t.v == 1 && t.kids.size() == 3 && t.kids[2].kids[0].v == 3);
+	CHECK(json_print_from(t, -1) == "{\"v\":1,\"kids\":[{\"v\":2,\"kids\":[]},{\"v\":0,\"kids\":[]},{\"v\":0,\"kids\":[{\"v\":3,\"kids\":[]}]}]}");
+	//読み飛ばすキーの値も残りの深さで制限
+	CHECK(json_parse_into("{\"x\":" + string(max - 1, '[') + string(max - 1, ']') + "}", t));
+	CHECK(!json_parse_into("{\"x\":" + string(max, '[') + string(max, ']') + "}", t));
+	vector<vector<int> > nested;
+	CHECK(json_parse_into("[[1],[]]", nested) && nested.size() == 2 && !json_parse_into(string(max + 1, '[') + string(max + 1, ']'), nested));
+
+	//vector<bool>は要素を読み込んでから追加(nullはfalse)
+	vector<bool> bits;
+	CHECK(json_parse_into("[true,false,null,true]", bits) && bits == vector<bool>({ true, false, false, true }));
+	CHECK(json_print_from(bits, -1) == "[true,false,false,true]" && json_parse_into(json_print_from(bits, 1), bits) && bits.size() == 4);
+	CHECK(!json_parse_into("[true,1]", bits) && !json_parse_into("[true,]", bits) && json_parse_into("[]", bits) && bits.empty());
+}
+
+struct check_point { double x; double y; };
+JSON_BIND(check_point, x, y)
+struct check_record { string name; bool active; vector<int> ids; vector<check_point> points; check_point origin; vector<vector<string> > grid; };
+JSON_BIND(check_record, name, active, ids, points, origin, grid)
+
+static bool same_record(const check_record& a, const check_record& b) {
+	if (a.name != b.name || a.active != b.active || a.ids != b.ids || a.grid != b.grid || a.points.size() != b.points.size()) return false;
+	if (a.origin.x != b.origin.x || a.origin.y != b.origin.y) return false;
+	for (size_t i = 0; i < a.points.size(); ++i) if (a.points[i].x != b.points[i].x || a.points[i].y != b.points[i].y) return false;
+	return true;
+}
+
+//構造体との変換
+static void test_bind() {
+	check_rng r(17);
+	for (int i = 0; i < 500; ++i) {
+		//書き出した結果はノードの出力と同じで、読み込むと元の値になる
+		check_record v;
+		v.name = string(r.below(20), 'n') + "\"\\\n\xC3\xA9";
+		v.active = r.below(2) != 0;
+		for (size_t k = r.below(10); k > 0; --k) v.ids.push_back((int)(r.next() >> 33) - (1 << 30));
+		for (size_t k = r.below(5); k > 0; --k) { check_point p = { (double)r.next() / 7, -(double)r.below(1000) / 8 }; v.points.push_back(p); }
+		v.origin.x = 1e-300 * (double)r.below(100);
+		v.origin.y = 0.1;
+		v.grid.resize(r.below(3), vector<string>(r.below(3), "g"));
+		const int indent = (int)r.below(3) - 1;
+		const string text = json_print_from(v, indent);
+		json_node<>* n = json_parse(text);
+		CHECK(n != nullptr && n->print(indent) == text);
+		delete n;
+		check_record back;
+		CHECK(json_parse_into(text, back) && same_record(v, back));
+		string streamed;
+		json_callback_sink cb([&](const char* p, size_t len) { streamed.append(p, len); return true; });
+		CHECK(json_print_from(cb, v, indent) && streamed == text);
+	}
+
+	//定義されていないキーは読み飛ばし、nullのメンバは変更しない
+	check_record v;
+	v.name = "keep";
+	v.active = true;
+	CHECK(json_parse_into("\xEF\xBB\xBF {\"unknown\":{\"deep\":[1,{\"name\":\"no\"}]},\"n\\u0061me\":null,\"ids\":[1,null,3],\"origin\":{\"y\":2,\"z\":\"}\"},\"points\":[],\"active\":null} ", v));
+	CHECK(v.name == "keep" && v.active && v.ids == vector<int>({ 1, 0, 3 }) && v.origin.y == 2 && v.points.empty());
+	CHECK(json_parse_into("{\"n\\u0061me\":\"escaped key\"}", v) && v.name == "escaped key");
+	//型が一致しない・不正な入力は失敗
+	const char* bad[] = { "{\"name\":1}", "{\"active\":\"true\"}", "{\"ids\":{}}", "{\"ids\":[1,]}", "{\"points\":[1]}", "{\"origin\":[]}",
+		"{\"grid\":[[1]]}", "{\"name\":\"x\"} x", "{\"name\":\"x\",}", "[]", "", "{\"unknown\":[1,}", "{\"name\" \"x\"}" };
+	for (const char* b : bad) CHECK(!json_parse_into(b, v));
+	CHECK(json_parse_into<vector<check_point> >("[{\"x\":1},{\"y\":2}]").size() == 2 && json_parse_into<vector<check_point> >("[{\"x\":true}]").empty());
+	CHECK(json_print_from(vector<check_point>(), -1) == "[]" && json_print_from(check_point(), 0) == "{\"x\":0.0,\"y\":0.0}");
+}
+
+//すべての読み込み方法で入れ子の深さが制限される(上限ちょうどは受理、超えた場合は拒否)
+static bool accepts_depth(const string& s) {
+	bool ok = true, any = false;
+	auto result = [&](const bool r) { if (!any) ok = r; else if (ok != r) { printf("depth %zu: readers disagree\n", s.size() / 2); ok = false; } any = true; };
+	json_node<>* n = json_parse(s);
+	result(n != nullptr);
+	delete n;
+	json_parser parser;
+	json_parse_result r = parser.parse(s);
+	result(bool(r));
+	delete r.node;
+	json_value v;
+	result(json_value::parse(s, v));
+	json_push_parser push;
+	result(push.feed(s) && push.finish() && push.available() == 1);
+	json_tape t;
+	result(t.parse(s));
+	json_document doc;
+	result(doc.parse(s) != nullptr);
+	result(doc.parse_lazy(s) != nullptr);
+	n = json_parse_parallel(s.data(), s.size(), 2, 0);
+	result(n != nullptr);
+	delete n;
+	vector<json_node<>*> lines = json_parse_ndjson(s + "\n1\n");
+	result(lines.size() == 2 && lines[0] != nullptr);
+	CHECK(lines.size() == 2 && print_or_null(lines[1]) == "1");
+	if (!lines.empty()) delete lines[0];
+	check_numbers b;
+	result(json_parse_into("{\"zz\":" + s + ",\"a\":1}", b));
+	n = json_query::path("a").extract_first("{\"zz\":" + s + ",\"a\":1}");
+	result(n != nullptr);
+	delete n;
+	return ok;
+}
+
+static void test_depth_limits() {
+	CHECK(accepts_depth(nested(100)));
+	//オブジェクトに入れた値の深さは1つ深くなる
+	CHECK(accepts_depth(nested(json_default_max_depth - 1)));
+	CHECK(!accepts_depth(nested(json_default_max_depth + 1)));
+	CHECK(!accepts_depth(nested(2000000)));
+	//バイナリ形式は別の上限(_json_binary_max_depth)
+	CHECK(json_from_cbor(string(2000000, '\x81') + '\0') == nullptr);
+	CHECK(json_from_msgpack(string(2000000, '\x91') + '\0') == nullptr);
+}
+
+//json_parserのエラーの種類と位置
+static bool parse_error_at(json_parser& parser, const string& s, const json_error e, const size_t offset, const size_t line, const size_t column) {
+	json_parse_result r = parser.parse(s);
+	delete r.node;
+	return !r && r.node == nullptr && r.error == e && r.offset == offset && r.line == line && r.column == column;
+}
+
+static void test_parser_errors() {
+	json_parser parser;
+	CHECK(parse_error_at(parser, "", json_error_eof, 0, 1, 1));
+	CHECK(parse_error_at(parser, "[1,", json_error_eof, 3, 1, 4));
+	CHECK(parse_error_at(parser, "[1 2]", json_error_syntax, 3, 1, 4));
+	CHECK(parse_error_at(parser, "[\"\\q\"]", json_error_string, 3, 1, 4));
+	CHECK(parse_error_at(parser, "{\"a\":\"x\ny\"}", json_error_string, 7, 1, 8));
+	CHECK(parse_error_at(parser, "[01]", json_error_number, 1, 1, 2));
+	CHECK(parse_error_at(parser, "-", json_error_number, 0, 1, 1));
+	//行と列は改行の後から数える
+	CHECK(parse_error_at(parser, "[\n  1,\n  tru]", json_error_syntax, 9, 3, 3));
+	CHECK(parse_error_at(parser, "{\"a\"\n:\n}", json_error_syntax, 7, 3, 1));
+	CHECK(parse_error_at(parser, "[1]\n x", json_error_trailing, 5, 2, 2));
+	CHECK(string(parser.parse("[1 2]").message()) == json_error_message(json_error_syntax));
+
+	//BOMと末尾の空白は受理する
+	json_parse_result r = parser.parse("\xEF\xBB\xBF[1]  \n");
+	CHECK(r && r.node != nullptr && r.node->print(0) == "[1]");
+	delete r.node;
+
+	//深さとサイズの上限
+	json_parser limited(3, 10);
+	CHECK(limited.max_depth() == 3 && limited.max_size() == 10);
+	r = limited.parse("[[[1]]]");
+	CHECK(r && print_or_null(r.node) == "[[[1]]]");
+	CHECK(parse_error_at(limited, "[[[[1]]]]", json_error_depth, 3, 1, 4));
+	CHECK(parse_error_at(limited, "[1,2,3,4,5]", json_error_size, 10, 1, 11));
+	r = limited.parse("[1,2,3,4]");
+	CHECK(r && print_or_null(r.node) == "[1,2,3,4]");
+	limited.set_max_size(0);
+	limited.set_max_depth(json_default_max_depth);
+	r = limited.parse("[1,2,3,4,5]");
+	CHECK(r && print_or_null(r.node) == "[1,2,3,4,5]");
+
+	//失敗の後も同じパーサーを再利用できる
+	for (int i = 0; i < 3; ++i) {
+		CHECK(parse_error_at(parser, nested(2000000), json_error_depth, json_default_max_depth, 1, json_default_max_depth + 1));
+		r = parser.parse(nested(100));
+		CHECK(r && print_or_null(r.node) == nested(100));
+		parser.shrink();
+	}
+}
+
+//出力のキャッシュ(ランダムに編集し、毎回print()と比較)
+static void collect_nodes(json_node<>* n, vector<json_node<>*>& out) {
+	out.push_back(n);
+	for (size_t i = 0, s = n->size(); i < s; ++i)
+		if (json_node<>* c = n->_child(i)) collect_nodes(c, out);
+}
+
+static bool is_within(json_node<>* n, json_node<>* ancestor) {
+	for (; n != nullptr; n = n->parent()) if (n == ancestor) return true;
+	return false;
+}
+
+static void edit_randomly(check_rng& r, json_node<>* root) {
+	vector<json_node<>*> nodes;
+	collect_nodes(root, nodes);
+	json_node<>* n = nodes[r.below(nodes.size())];
+	const string key = string(1, (char)('a' + r.below(4)));
+	switch (r.below(12)) {
+		case 0: n->set_string("s" + std::to_string(r.below(100))); break;
+		case 1: n->set_number((double)r.below(1000) / 8); break;
+		case 2: n->set_bool(r.below(2) == 1); break;
+		case 3: n->emplace_object<json_number<>>(key, (double)r.below(10)); n->emplace_array<json_array<>>(); break;
+		case 4: n->emplace_object<json_object<>>(key); n->emplace_array<json_string<>>("x"); break;
+		case 5: n->delete_object(key); n->delete_array(r.below(3), (int)r.below(2)); break;
+		case 6: if (n != root) delete n; break;
+		case 7: case 10: case 11: {
+			//別のコンテナへ移動
+			json_node<>* to = nodes[r.below(nodes.size())];
+			if (n == root || is_within(to, n)) break;
+			if (to->type() == Array) to->add_array(n);
+			else if (to->type() == Object) to->set_object("m" + std::to_string(r.below(1000)), n);
+			break;
+		}
+		case 8: n->delete_empty(); n->resize(r.below(4)); break;
+		default: n->clear_print_cache(); break;
+	}
+}
+
+static void test_print_cached() {
+	check_rng r(11);
+	const char* deep = "{\"a\":{\"b\":[1,{\"c\":[2,3]}],\"e\":{\"f\":{\"g\":4}}},\"d\":[[5],[6,{\"h\":\"\\n\"}]]}";
+	for (size_t round = 0; round < 200; ++round) {
+		const char* seed = round % 4 < 2 ? deep : check_seeds[round % (sizeof(check_seeds) / sizeof(check_seeds[0]))];
+		json_document doc(512);
+		json_node<>* root = round % 2 == 0 ? json_parse(seed) : doc.parse(seed);
+		if (root == nullptr || (root->type() != Object && root->type() != Array)) {
+			if (round % 2 == 0) delete root;
+			continue;
+		}
+		//キャッシュはインデントが同じ場合のみ使用するため、編集の間は同じインデントで出力
+		const int indent = (int)(round / 4 % 3);
+		for (size_t i = 0; i < 30; ++i) {
+			edit_randomly(r, root);
+			CHECK(root->print_cached(indent) == root->print(indent));
+		}
+		//インデントや起点が変わる場合は作り直す
+		CHECK(root->print_cached(indent, "  ") == root->print(indent, "  "));
+		vector<json_node<>*> nodes;
+		collect_nodes(root, nodes);
+		json_node<>* sub = nodes[r.below(nodes.size())];
+		CHECK(sub->print_cached(indent + 1) == sub->print(indent + 1));
+		CHECK(root->print_cached(indent) == root->print(indent));
+		if (round % 2 == 0) delete root;
+	}
+
+	//値の変更は親ノードまでのキャッシュを破棄する
+	json_node<>* n = json_parse("{\"a\":{\"b\":[1,{\"c\":\"x\"}]},\"d\":[2]}");
+	CHECK(n->print_cached(0) == "{\"a\":{\"b\":[1,{\"c\":\"x\"}]},\"d\":[2]}");
+	(*n)["a"]["b"][1]["c"].set_string("y");
+	CHECK(n->print_cached(0) == "{\"a\":{\"b\":[1,{\"c\":\"y\"}]},\"d\":[2]}");
+	(*n)["a"]["b"][0].set_int(-3);
+	CHECK(n->print_cached(0) == "{\"a\":{\"b\":[-3,{\"c\":\"y\"}]},\"d\":[2]}");
+	n->get_object("d")->add_array(n->get_object("a")->get_object("b"));
+	CHECK(n->print_cached(0) == "{\"a\":{},\"d\":[2,[-3,{\"c\":\"y\"}]]}");
+	delete &(*n)["d"][1][1];
+	CHECK(n->print_cached(0) == "{\"a\":{},\"d\":[2,[-3]]}");
+	CHECK(n->print_cached(1) == n->print(1));
+	delete n;
+}
+
+//共有される値(同じ編集をノードにも適用し、以前の版が変わらないことを確認)
+static void edit_value_randomly(check_rng& r, json_value& doc, json_node<>* root) {
+	json_value* v = &doc;
+	json_node<>* n = root;
+	while (v->size() > 0 && r.below(3) != 0) {
+		const size_t i = r.below(v->size());
+		if (v->type() == Object) {
+			const string key = v->child_key(i)->str();
+			v = v->edit_object(key);
+			n = n->get_object(key);
+		} else {
+			v = v->edit_array(i);
+			n = n->get_array(i);
+		}
+	}
+	if (v->type() != Object && v->type() != Array) return;
+	const string key = "k" + std::to_string(r.below(20));
+	const string str = "s" + std::to_string(r.below(100));
+	switch (r.below(6)) {
+		case 0: v->set_object(key, str); n->emplace_object<json_string<>>(key, str); break;
+		case 1: v->set_object(key, json_value::object()); n->emplace_object<json_object<>>(key); break;
+		case 2: v->add_array(str); n->emplace_array<json_string<>>(str); break;
+		case 3: v->add_array(json_value::array()); n->emplace_array<json_array<>>(); break;
+		case 4: v->delete_object(key); n->delete_object(key); break;
+		default: {
+			const size_t i = r.below(v->size() + 1);
+			if (i < v->size() && v->type() == Array) {
+				v->delete_array(i);
+				n->delete_array(i, 1);
+			}
+			break;
+		}
+	}
+}
+
+static void test_value_sharing() {
+	json_value doc;
+	CHECK(json_value::parse("{\"a\":{\"b\":[1,2]},\"d\":[3,{\"e\":\"f\"}],\"g\":\"h\"}", doc));
+	json_value snapshot = doc;
+	CHECK(doc.shares(snapshot) && doc.use_count() == 2);
+	doc.edit_object("a")->set_object("b", 1);
+	doc.set_object("c", "str");
+	CHECK(snapshot.print(0) == "{\"a\":{\"b\":[1,2]},\"d\":[3,{\"e\":\"f\"}],\"g\":\"h\"}");
+	CHECK(doc.print(0) == "{\"a\":{\"b\":1},\"d\":[3,{\"e\":\"f\"}],\"g\":\"h\",\"c\":\"str\"}");
+	//変更箇所までの経路のみ複製し、それ以外は共有する
+	CHECK(!doc.shares(snapshot) && snapshot.use_count() == 1);
+	CHECK(!doc["a"].shares(snapshot["a"]) && doc["d"].shares(snapshot["d"]) && doc["g"].shares(snapshot["g"]));
+	CHECK(snapshot["a"]["b"].use_count() == 1 && doc["d"].use_count() == 2);
+	json_value second = doc;
+	doc.edit_object("d")->edit_array(1)->set_string("x");
+	CHECK(second["d"][1]["e"].get_string() == "f" && doc["d"][1].get_string() == "x");
+	CHECK(doc["d"][0].shares(second["d"][0]) && doc["d"][0].shares(snapshot["d"][0]) && doc["a"].shares(second["a"]));
+	//値の置き換えは共有している版に影響しない
+	json_value leaf = doc["g"];
+	doc.edit_object("g")->set_int(5);
+	CHECK(leaf.get_string() == "h" && second["g"].get_string() == "h" && doc["g"].get_int() == 5);
+	doc.edit_object("g")->set_null();
+	CHECK(doc["g"].type() == Null && doc.size() == 4);
+	//範囲外の設定はnullで埋める
+	json_value arr = json_value::array();
+	arr.set_array(2, true);
+	CHECK(arr.print(0) == "[null,null,true]");
+	//ノードとの変換
+	json_node<>* n = doc.to_node();
+	CHECK(print_or_null(n->clone()) == doc.print(0));
+	CHECK(json_value(n).print(1) == doc.print(1));
+	delete n;
+
+	//ランダムな編集と以前の版
+	check_rng r(23);
+	for (size_t round = 0; round < 20; ++round) {
+		json_value v = json_value::object();
+		json_node<>* mirror = new json_object<>;
+		vector<pair<json_value, string>> versions;
+		for (size_t i = 0; i < 300; ++i) {
+			edit_value_randomly(r, v, mirror);
+			if (i % 10 == 0) versions.push_back(make_pair(v, v.print(0)));
+		}
+		CHECK(v.print(0) == mirror->print(0));
+		//索引を使用する大きさのオブジェクトでも検索できる
+		for (size_t k = 0; k < 20; ++k) {
+			const string key = "k" + std::to_string(k);
+			CHECK((v.get_object(key) != nullptr) == (mirror->get_object(key) != nullptr));
+		}
+		for (auto& e : versions) CHECK(e.first.print(0) == e.second);
+		delete mirror;
+	}
+
+	//スナップショットは別のスレッドで読み取れる
+	json_value base;
+	CHECK(json_value::parse("{\"a\":[1,2,3],\"b\":{\"c\":\"d\"}}", base));
+	vector<thread> readers;
+	bool same[4];
+	for (int t = 0; t < 4; ++t) {
+		readers.push_back(thread([base, &same, t]() {
+			same[t] = true;
+			for (int i = 0; i < 200; ++i) same[t] = same[t] && base.print(0) == "{\"a\":[1,2,3],\"b\":{\"c\":\"d\"}}";
+		}));
+	}
+	json_value edit = base;
+	for (int i = 0; i < 200; ++i) edit.edit_object("a")->set_array(0, i);
+	for (thread& t : readers) t.join();
+	CHECK(same[0] && same[1] && same[2] && same[3]);
+	CHECK(edit["a"][0].get_int() == 199 && edit["b"].shares(base["b"]));
+}
+
+//読み取り専用の文書と公開
+static void test_frozen() {
+	json_node<>* n = json_parse("{\"a\":[1,2],\"b\":{\"c\":\"d\"},\"k0\":0,\"k1\":1,\"k2\":2,\"k3\":3,\"k4\":4,\"k5\":5,\"k6\":6,\"k7\":7,\"k8\":8}");
+	shared_ptr<const json_frozen> doc = json_freeze(n);
+	const string text = n->print(0);
+	//ノードは複製するため、以降の変更は影響しない
+	n->set_object("a", n->get_object("b")->clone());
+	delete n;
+	CHECK(doc->print(0) == text && doc->type() == Object && doc->size() == 11);
+	CHECK((*doc)["a"][1].get_int() == 2 && (*doc)["b"]["c"].get_string() == "d" && (*doc)["k8"].get_int() == 8);
+	CHECK((*doc)["x"].type() == Null && (*doc)["a"][5].type() == Null && doc->get_object("x") == nullptr && doc->get_array(0) == nullptr);
+	//読み取りは参照カウントを変更しない
+	const json_value& a = (*doc)["a"];
+	CHECK(a.use_count() == 1 && &(*doc)["a"] == &a);
+	json_value edit = doc->thaw();
+	edit.edit_object("a")->add_array(3);
+	CHECK(doc->print(0) == text && edit["a"].size() == 3 && edit["b"].shares((*doc)["b"]));
+	CHECK(json_freeze((json_node<>*)nullptr) == nullptr && json_freeze_parse("{") == nullptr);
+
+	//版の入れ替え
+	json_publisher<> pub(json_freeze_parse("{\"v\":1}"));
+	json_publisher<>::reader r(pub);
+	const uint64_t v1 = pub.version();
+	const json_frozen* first = r.operator->();
+	CHECK((*r)["v"].get_int() == 1 && r.operator->() == first && pub.load().get() == first);
+	weak_ptr<const json_frozen> old = pub.load();
+	shared_ptr<const json_frozen> prev = pub.exchange(json_freeze(move(edit)));
+	CHECK(prev.get() == first && pub.version() == v1 + 1);
+	prev.reset();
+	//読み取り側が保持している間は以前の版を解放しない
+	CHECK(!old.expired() && r->size() == 11 && old.expired());
+	r.release();
+	pub.publish(nullptr);
+	CHECK(r.current() == nullptr && pub.version() == v1 + 2);
+
+	//複数のスレッドから読み取りながら公開
+	pub.publish(json_freeze_parse("{\"v\":0,\"w\":[0]}"));
+	atomic<bool> done(false);
+	bool consistent[4];
+	vector<thread> readers;
+	for (int t = 0; t < 4; ++t) {
+		readers.push_back(thread([&pub, &done, &consistent, t]() {
+			json_publisher<>::reader rd(pub);
+			int64_t last = 0;
+			bool ok = true;
+			while (!done.load()) {
+				const json_frozen& d = *rd;
+				const int64_t v = d["v"].get_int();
+				ok = ok && v >= last && d["w"][0].get_int() == v && d["w"].size() == 1;
+				last = v;
+			}
+			consistent[t] = ok;
+		}));
+	}
+	for (int i = 1; i <= 300; ++i) {
+		json_value next = pub.load()->thaw();
+		next.set_object("v", i);
+		next.edit_object("w")->set_array(0, i);
+		pub.publish(json_freeze(move(next)));
+	}
+	done = true;
+	for (thread& t : readers) t.join();
+	CHECK(consistent[0] && consistent[1] && consistent[2] && consistent[3]);
+	CHECK((*pub.load())["v"].get_int() == 300);
+}
+
+//コピー・変換をしない取得と追加
+static void test_value_access() {
+	const string text = "{\"name\":\"a long name that does not fit in sso\",\"esc\":\"a\\nb\",\"id\":42,\"big\":18446744073709551615,\"neg\":-1,\"half\":1.5,\"exp\":1e3,\"t\":true,\"s\":\"true\"}";
+	json_document doc;
+	json_node<>* arena_root = doc.parse(text);
+	json_node<>* heap_root = json_parse(text);
+	for (json_node<>* root : { arena_root, heap_root }) {
+		json_string_view name;
+		int64_t i = 0;
+		uint64_t u = 0;
+		double d = 0;
+		bool b = false;
+		//型が一致する場合のみ取得し、メモリを確保しない
+		const size_t before = g_news.load();
+		CHECK((*root)["name"].try_get_string(name) && name == "a long name that does not fit in sso");
+		CHECK(root->get_object("id")->try_get_int(i) && i == 42 && (*root)["id"].try_get_uint(u) && u == 42);
+		CHECK((*root)["half"].try_get_number(d) && d == 1.5 && !(*root)["half"].try_get_int(i));
+		CHECK((*root)["exp"].try_get_int(i) && i == 1000);
+		CHECK((*root)["big"].try_get_uint(u) && u == UINT64_MAX && !(*root)["big"].try_get_int(i));
+		CHECK(!(*root)["neg"].try_get_uint(u) && (*root)["neg"].try_get_int(i) && i == -1);
+		CHECK((*root)["t"].try_get_bool(b) && b && !(*root)["s"].try_get_bool(b) && !(*root)["t"].try_get_string(name));
+		CHECK(!(*root)["id"].try_get_string(name) && !(*root)["name"].try_get_number(d) && !(*root)["missing"].try_get_int(i));
+		CHECK(root->get_string_view().size() == 0 && (*root)["missing"].get_string_view().size() == 0);
+		CHECK(g_news.load() == before);
+		CHECK((*root)["name"].get_string().size() == name.size() && g_news.load() > before);
+		//エスケープを含む文字列は変換後の文字列を返す
+		CHECK((*root)["esc"].get_string_view() == "a\nb" && (*root)["esc"].get_string_view() == "a\nb");
+		CHECK((*root)["s"].get_bool() && !(*root)["name"].get_bool());
+	}
+	delete heap_root;
+
+	//移動で追加した文字列はコピーしない
+	json_node<>* root = new json_object<>;
+	root->reserve(16);
+	string str(100, 'x');
+	const char* data = str.data();
+	json_string<>* s = root->emplace_object<json_string<>>("f", std::move(str));
+	CHECK(s != nullptr && s->str().data() == data && s->parent() == root);
+	string other(100, 'y');
+	data = other.data();
+	s->set_string(std::move(other));
+	CHECK(s->str().data() == data && (*root)["f"].get_string_view() == string(100, 'y'));
+	json_node<>* arr = root->emplace_object<json_array<>>("g");
+	arr->reserve(4);
+	CHECK(arr->emplace_array<json_number<>>(1) != nullptr && arr->emplace_array<json_number<>>(UINT64_MAX) != nullptr);
+	CHECK(arr->emplace_array<json_string<>>("z", 1) != nullptr && arr->emplace_array<json_boolean<>>(true) != nullptr);
+	CHECK(root->emplace_array<json_null<>>() == nullptr && arr->emplace_object<json_null<>>("k") == nullptr);
+	CHECK(arr->print(0) == "[1,18446744073709551615,\"z\",true]");
+	arr->delete_array(1, 1);
+	arr->delete_array(0);
+	arr->delete_array(10, 1);
+	CHECK(arr->size() == 3 && arr->print(0) == "[\"z\",true]");
+	//アリーナ上のコンテナには同じアリーナにノードを作成する
+	json_node<>* added = arena_root->emplace_object<json_array<>>("added");
+	CHECK(added->arena() == arena_root->arena() && added->emplace_array<json_string<>>(string(50, 'q'))->arena() == arena_root->arena());
+	CHECK((*arena_root)["added"][0].get_string_view() == string(50, 'q'));
+	delete root;
+}
+
+//アリーナ上のドキュメント
+static void test_document() {
+	const string text = "{\"a\":[1,2,{\"b\":\"long string value that does not fit in sso\"}],\"c\":true}";
+	json_node<>* copy = nullptr;
+	{
+		json_document doc(256); //小さいチャンクで複数回確保させる
+		json_node<>* root = doc.parse(text);
+		CHECK(root != nullptr && root == doc.root() && root->arena() != nullptr);
+		CHECK((*root)["a"][2].arena() == root->arena() && (*root)["a"][2]["b"].arena() == root->arena());
+		CHECK(print_or_null(json_parse(text)) == root->print(0));
+
+		//アリーナ上のノードとヒープのノードを混在させて編集
+		root->set_object("d", doc.create<json_string<>>("str"));
+		root->set_object("e", new json_number<>(5));
+		delete &(*root)["a"][0];
+		root->delete_object("c");
+		CHECK(root->print(0) == "{\"a\":[2,{\"b\":\"long string value that does not fit in sso\"}],\"d\":\"str\",\"e\":5}");
+
+		//複製はヒープに作成され、ドキュメントの破棄後も使用できる
+		copy = root->clone();
+		CHECK(copy->arena() == nullptr && (*copy)["a"].arena() == nullptr);
+
+		//読み直すと以前のノードは破棄される
+		for (int i = 0; i < 100; ++i) root = doc.parse(text);
+		CHECK(root != nullptr && (*root)["c"].get_bool());
+		doc.clear();
+		CHECK(doc.root() == nullptr);
+		CHECK(doc.parse("[") == nullptr && doc.root() == nullptr);
+		CHECK(doc.set_root(doc.create<json_array<>>())->size() == 0);
+	}
+	CHECK((*copy)["d"].get_string() == "str" && (*copy)["a"][2]["b"].get_string().size() == 42);
+	delete copy;
+}
+
+//ファイルからの読み込み
+static string write_temp(const string& text) {
+	char path[] = "/tmp/json_check_XXXXXX";
+	const int fd = mkstemp(path);
+	if (fd < 0) return "";
+	close(fd);
+	FILE* f = fopen(path, "wb");
+	fwrite(text.data(), 1, text.size(), f);
+	fclose(f);
+	return path;
+}
+
+static void test_file() {
+	const string text = "\xEF\xBB\xBF{\"plain\":\"abc\",\"esc\":\"a\\nb\\u00e9\",\"list\":[1,\"x\",{\"k\":\"v\\\"\"}]}";
+	const string expect = "{\"plain\":\"abc\",\"esc\":\"a\\nb\xC3\xA9\",\"list\":[1,\"x\",{\"k\":\"v\\\"\"}]}";
+	const string path = write_temp(text);
+	CHECK(!path.empty());
+	CHECK(print_or_null(json_parse_file(path)) == expect);
+
+	json_node<>* copy = nullptr;
+	{
+		json_document doc;
+		json_node<>* root = doc.parse_file(path);
+		CHECK(root != nullptr);
+		if (root == nullptr) return;
+		//文字列はマップした領域を参照し、エスケープを含む場合は取得時に変換する
+		json_string_ref<>* plain = dynamic_cast<json_string_ref<>*>(&(*root)["plain"]);
+		json_string_ref<>* esc = dynamic_cast<json_string_ref<>*>(&(*root)["esc"]);
+		CHECK(plain != nullptr && esc != nullptr);
+		if (plain != nullptr && esc != nullptr) {
+			CHECK(plain->is_view() && plain->length() == 3 && memcmp(plain->data(), "abc", 3) == 0 && plain->is_view());
+			CHECK(esc->is_view() && esc->get_string() == "a\nb\xC3\xA9" && !esc->is_view() && esc->length() == 5);
+			CHECK(root->print(0) == expect);
+			esc->set_string("edited");
+			CHECK(esc->get_string() == "edited" && (*root)["esc"].print(0) == "\"edited\"");
+		}
+		CHECK((*root)["list"][2]["k"].get_string() == "v\"");
+		//エスケープを含まないキーもマップした領域を参照する
+		if (plain != nullptr) CHECK(root->_child_key(0)->data + 8 == plain->data() && root->_child_key(0)->len == 5);
+		copy = root->clone();
+
+		//遅延読み込み
+		json_node<>* lazy = doc.parse_file_lazy(path);
+		CHECK(lazy != nullptr && lazy->print(0) == expect && (*lazy)["list"][1].get_string() == "x");
+	}
+	//複製はドキュメント・ファイルの破棄後も使用できる
+	remove(path.c_str());
+	CHECK(copy != nullptr && (*copy)["list"][2]["k"].get_string() == "v\"" && (*copy)["esc"].get_string() == "edited");
+	delete copy;
+
+	//エスケープを含むキーは変換し、参照するキーと同じキーとして扱う
+	const string keyed = write_temp("{\"k\\u0031\":1,\"k1\":2,\"ab\":{\"ab\":3}}");
+	{
+		json_document doc;
+		json_node<>* root = doc.parse_file(keyed);
+		CHECK(print_or_null(root != nullptr ? root->clone() : nullptr) == "{\"k1\":2,\"ab\":{\"ab\":3}}");
+		CHECK(root != nullptr && (*root)["k1"].get_int() == 2 && (*root)["ab"]["ab"].get_int() == 3);
+		CHECK(print_or_null(json_value(root).to_node()) == "{\"k1\":2,\"ab\":{\"ab\":3}}");
+		json_key_table keys;
+		doc.set_keys(&keys);
+		root = doc.parse_file(keyed);
+		CHECK(root != nullptr && keys.size() == 2 && root->_child_key(1) == keys.intern("ab").get());
+		doc.clear();
+		copy = new json_object<>;
+		//複製したノードのキーはドキュメントの破棄後も使用できる
+		root = doc.parse_file(keyed);
+		copy->set_object("moved", root->get_object("ab")->clone());
+		doc.clear();
+		CHECK(copy->print(0) == "{\"moved\":{\"ab\":3}}");
+		delete copy;
+	}
+	remove(keyed.c_str());
+
+	//存在しない・不正なファイル
+	json_document doc;
+	CHECK(json_parse_file(path) == nullptr && doc.parse_file(path) == nullptr && doc.parse_file_lazy(path) == nullptr);
+	const string empty = write_temp(""), broken = write_temp("[1,2");
+	CHECK(json_parse_file(empty) == nullptr && doc.parse_file(empty) == nullptr);
+	CHECK(json_parse_file(broken) == nullptr && doc.parse_file(broken) == nullptr && doc.root() == nullptr);
+	remove(empty.c_str());
+	remove(broken.c_str());
+}
+
+//書き出し先への出力
+static json_node<>* large_document() {
+	//書き出しのバッファより大きな出力になるドキュメント
+	json_array<>* root = new json_array<>;
+	for (int i = 0; i < 3000; ++i) {
+		json_object<>* o = root->emplace_array<json_object<>>();
+		o->emplace_object<json_number<>>("id", i);
+		o->emplace_object<json_string<>>("name", "item \"" + to_string(i) + "\"\n");
+		o->set_object("tags", json_parse("[true,null,1.5,{\"nested\":[]}]"));
+	}
+	root->emplace_array<json_string<>>(string(200000, 'x')); //バッファより長い文字列
+	return root;
+}
+
+static void test_sink() {
+	json_node<>* doc = large_document();
+	const int indents[] = { -1, 0, 1, 3 };
+	for (const int indent : indents) {
+		for (const char* indentstr : { "\t", "  " }) {
+			const string expect = doc->print(indent, indentstr);
+			string out;
+			size_t calls = 0;
+			json_callback_sink cb([&](const char* p, size_t n) { out.append(p, n); ++calls; return true; });
+			CHECK(doc->print_to(cb, indent, indentstr) && out == expect && calls > 1);
+			ostringstream os;
+			json_ostream_sink oss(os);
+			CHECK(doc->print_to(oss, indent, indentstr) && os.str() == expect);
+		}
+	}
+	//インデント文字列を指定した出力
+	json_node<>* small = json_parse("{\"a\":[1,{\"b\":2}]}");
+	CHECK(small->print(1, "  ") == "{\n  \"a\" : [\n    1,\n    {\n      \"b\" : 2\n    }\n  ]\n}");
+	delete small;
+
+	//ファイル・ファイルディスクリプタ
+	const string expect = doc->print(1);
+	const string path = write_temp("");
+	FILE* f = fopen(path.c_str(), "wb");
+	json_file_sink fs(f);
+	CHECK(doc->print_to(fs));
+	fclose(f);
+	json_node<>* back = json_parse_file(path);
+	CHECK(back != nullptr && back->print(1) == expect);
+	delete back;
+	const int fd = open(path.c_str(), O_WRONLY | O_TRUNC);
+	json_fd_sink fds(fd);
+	CHECK(fd >= 0 && (*doc)[1].print_to(fds, -1));
+	close(fd);
+	back = json_parse_file(path);
+	CHECK(print_or_null(back) == (*doc)[1].print(0));
+	remove(path.c_str());
+
+	//書き出し先が失敗すると以降は出力せずfalse
+	size_t calls = 0;
+	json_callback_sink fail([&](const char*, size_t) { ++calls; return false; });
+	CHECK(!doc->print_to(fail) && calls == 1);
+	FILE* ro = fopen("/dev/null", "rb");
+	json_file_sink bad(ro);
+	CHECK(!doc->print_to(bad));
+	fclose(ro);
+	delete doc;
+}
+
+//オブジェクトの挿入順と検索
+static void test_object_order() {
+	check_rng r(10);
+	for (int round = 0; round < 300; ++round) {
+		//挿入順のキーと値の単純な実装と比較
+		vector<pair<string, int> > model;
+		json_object<> o;
+		if (r.below(4) == 0) o.reserve(r.below(64));
+		const size_t keys = 1 + r.below(r.below(2) ? 8 : 60); //線形探索とハッシュ索引の両方
+		for (int op = 0; op < 200; ++op) {
+			const string key = "k" + to_string(r.below(keys));
+			size_t at = 0;
+			while (at < model.size() && model[at].first != key) ++at;
+			switch (r.below(4)) {
+				case 0: case 1: { //追加・変更(既存のキーは位置を保つ)
+					const int v = (int)r.below(1000);
+					o.emplace_object<json_number<>>(key, v);
+					if (at < model.size()) model[at].second = v;
+					else model.push_back(make_pair(key, v));
+					break;
+				}
+				case 2: //削除
+					o.delete_object(key);
+					if (at < model.size()) model.erase(model.begin() + at);
+					break;
+				case 3: //値のノードを直接削除すると要素も無くなる
+					if (at < model.size()) {
+						delete &o[key];
+						model.erase(model.begin() + at);
+						if (r.below(2)) o.delete_empty();
+					}
+					break;
+			}
+			const string k = "k" + to_string(r.below(keys));
+			size_t found = 0;
+			while (found < model.size() && model[found].first != k) ++found;
+			CHECK(found < model.size() ? o[k].get_int() == model[found].second : o[k].type() == Null && o.get_object(k) == nullptr);
+		}
+		string expect = "{";
+		for (size_t i = 0; i < model.size(); ++i) expect += (i ? ",\"" : "\"") + model[i].first + "\":" + to_string(model[i].second);
+		expect += "}";
+		CHECK(o.print(0) == expect);
+		o.delete_empty(); //中身を削除した要素は参照またはdelete_emptyまで残る
+		CHECK(o.size() == model.size());
+		CHECK(print_or_null(o.clone()) == expect);
+		for (const auto& e : model) CHECK(o[e.first].get_int() == e.second);
+	}
+
+	//索引付きの大きなオブジェクトで削除と検索を交互に行う(削除済みの要素は後でまとめて詰める)
+	{
+		vector<pair<string, int> > model;
+		json_object<> o;
+		for (int i = 0; i < 3000; ++i) {
+			o.emplace_object<json_number<>>("k" + to_string(i), i);
+			model.push_back(make_pair("k" + to_string(i), i));
+		}
+		bool ok = true;
+		for (int op = 0; op < 6000 && ok; ++op) {
+			const string key = "k" + to_string(r.below(4000));
+			size_t at = 0;
+			while (at < model.size() && model[at].first != key) ++at;
+			const bool add = r.below(3) == 0;
+			if (add) {
+				o.emplace_object<json_number<>>(key, op); //削除後の再追加は末尾
+				if (at < model.size()) model[at].second = op;
+				else model.push_back(make_pair(key, op));
+			} else {
+				o.delete_object(key);
+				if (at < model.size()) model.erase(model.begin() + at);
+			}
+			json_node<>* v = o.get_object(key);
+			const string k = "k" + to_string(r.below(4000));
+			size_t found = 0;
+			while (found < model.size() && model[found].first != k) ++found;
+			json_node<>* w = o.get_object(k);
+			ok = o.size() == model.size() && (add ? v != nullptr && v->get_int() == op : v == nullptr)
+				&& (found < model.size() ? w != nullptr && w->get_int() == model[found].second : w == nullptr);
+			if (op % 1000 == 0) { //途中の複製にも削除済みの要素は含まれない
+				json_node<>* c = o.clone();
+				ok = ok && c->size() == model.size();
+				delete c;
+			}
+		}
+		CHECK(ok);
+		string expect = "{";
+		for (size_t i = 0; i < model.size(); ++i) expect += (i ? ",\"" : "\"") + model[i].first + "\":" + to_string(model[i].second);
+		expect += "}";
+		CHECK(o.print(0) == expect);
+		CHECK(o.size() == model.size());
+		bool order = true;
+		for (size_t i = 0; i < model.size(); ++i) order = order && string(o._child_key(i)->data, o._child_key(i)->len) == model[i].first && o._child(i)->get_int() == model[i].second;
+		CHECK(order && o._child(model.size()) == nullptr);
+	}
+
+	//読み込んだ順に出力し、重複したキーは最後の値で最初の位置
+	const string text = "{\"z\":1,\"a\":2,\"m\":3,\"a\":4,\"b\":5,\"c\":6,\"d\":7,\"e\":8,\"f\":9,\"g\":10}";
+	json_node<>* n = json_parse(text);
+	CHECK(n->print(0) == "{\"z\":1,\"a\":4,\"m\":3,\"b\":5,\"c\":6,\"d\":7,\"e\":8,\"f\":9,\"g\":10}" && n->size() == 9);
+	CHECK((*n)[1].type() == Null && (*n)["g"].get_int() == 10);
+	json_key_table keys;
+	CHECK((*n)[keys.intern("m")].get_int() == 3 && (*n)[keys.intern("none")].type() == Null);
+	delete n;
+}
+
+//キーの共有
+static void test_key_table() {
+	json_key_table keys;
+	const string text = "{\"timestamp\":1,\"user_id\":\"u\",\"nested\":{\"timestamp\":2}}";
+	json_node<>* a = json_parse(text, &keys);
+	json_node<>* b = json_parse(text, &keys);
+	CHECK(a != nullptr && b != nullptr && keys.size() == 3);
+	//同じキーは1つにまとめられる
+	CHECK(a->_child_key(0) == b->_child_key(0) && a->_child_key(0) == (*a)["nested"]._child_key(0));
+	const json_key ts = keys.intern("timestamp");
+	CHECK(ts.get() == a->_child_key(0) && keys.size() == 3);
+	CHECK((*a)[ts].get_int() == 1 && (*b)["nested"][ts].get_int() == 2);
+	//表を使わずに読み込んだノードも文字列の比較で検索できる
+	json_node<>* plain = json_parse(text);
+	CHECK((*plain)[ts].get_int() == 1 && plain->_child_key(0) != ts.get());
+	delete plain;
+
+	//表を空にしても使用中のキーはノードの破棄まで有効
+	keys.reset();
+	CHECK(keys.size() == 0 && (*a)[ts].get_int() == 1 && a->_child_key(1)->len == 7);
+	json_node<>* c = json_parse(text, &keys);
+	CHECK(c->_child_key(0) != a->_child_key(0) && (*c)[ts].get_int() == 1);
+	delete a;
+	delete b;
+	CHECK((*c)["user_id"].get_string() == "u");
+	delete c;
+
+	//上限を超えたキーは共有しない
+	json_key_table limited(2);
+	CHECK(limited.intern("a").get() == limited.intern("a").get() && limited.intern("b").get() == limited.intern("b").get());
+	CHECK(limited.intern("c").get() != limited.intern("c").get() && limited.intern("c") == limited.intern("c") && limited.size() == 2);
+	limited.set_limit(0);
+	CHECK(limited.intern("c").get() == limited.intern("c").get() && limited.size() == 3 && limited.limit() == 0);
+
+	//表の拡張後も同じキーを返す
+	json_key_table many;
+	vector<json_key> interned;
+	for (int i = 0; i < 1000; ++i) interned.push_back(many.intern("key" + to_string(i)));
+	CHECK(many.size() == 1000);
+	for (int i = 0; i < 1000; ++i) CHECK(many.intern("key" + to_string(i)).get() == interned[i].get() && interned[i].str() == "key" + to_string(i));
+
+	//ドキュメント・分割入力の読み込みでも共有する
+	json_document doc;
+	doc.set_keys(&many);
+	CHECK(doc.parse("{\"key5\":5}") != nullptr && doc.root()->_child_key(0) == interned[5].get());
+	json_push_parser pp(nullptr, &many);
+	CHECK(pp.feed("{\"key6\":6}") && pp.available() == 1);
+	json_node<>* pushed = pp.next();
+	CHECK(pushed->_child_key(0) == interned[6].get() && (*pushed)[interned[6]].get_int() == 6);
+	delete pushed;
+}
+
+//改行区切りJSON
+static void test_ndjson() {
+	check_rng r(12);
+	//正しい行・不正な行・空行を混在させ、行ごとに読み込んだ結果と比較
+	string text;
+	vector<pair<size_t, string> > expect; //行番号と出力(失敗した行は"(null)")
+	size_t failures = 0;
+	for (size_t line = 0; line < 3000; ++line) {
+		string s;
+		switch (r.below(6)) {
+			case 0: s = ""; break;
+			case 1: s = " \t\r"; break;
+			case 2: s = mutate(r, check_seeds[r.below(sizeof(check_seeds) / sizeof(check_seeds[0]))]); break;
+			default: s = "{\"line\":" + to_string(line) + ",\"v\":[\"" + string(r.below(40), 'x') + "\"]}"; break;
+		}
+		if (s.find('\n') != string::npos) s = "[1]";
+		if (r.below(4) == 0) s += "\r"; //CRLF
+		text += s;
+		if (line + 1 < 3000 || r.below(2)) text += '\n';
+		if (_json_skip_ws(s.data(), 0, s.size()) == s.size()) continue;
+		size_t pos = _json_skip_ws(s.data(), 0, s.size());
+		string e_temp;
+		json_node<>* n = _json_parse_type(s, pos, e_temp);
+		if (n != nullptr && _json_skip_ws(s.data(), pos, s.size()) != s.size()) { delete n; n = nullptr; }
+		if (n == nullptr) ++failures;
+		expect.push_back(make_pair(line, print_or_null(n)));
+	}
+	const unsigned threads[] = { 1, 4 };
+	const size_t blocks[] = { 1, 100, 4096, 1 << 20 };
+	for (const unsigned t : threads) {
+		for (const size_t block : blocks) {
+			json_ndjson_parser parser(t, block);
+			vector<pair<size_t, string> > got;
+			CHECK(parser.parse(text, [&](size_t line, json_node<>* n) { got.push_back(make_pair(line, print_or_null(n))); return true; }));
+			CHECK(got == expect && parser.errors() == failures);
+
+			//中断すると以降は呼び出されない
+			size_t calls = 0;
+			CHECK(!parser.parse(text, [&](size_t, json_node<>* n) { delete n; return ++calls < 100; }) && calls == 100);
+		}
+	}
+	vector<json_node<>*> all = json_parse_ndjson(text, 2);
+	CHECK(all.size() == expect.size());
+	for (size_t i = 0; i < all.size() && i < expect.size(); ++i) CHECK(print_or_null(all[i]) == expect[i].second);
+
+	const string path = write_temp("\xEF\xBB\xBF{\"a\":1}\n\n[2]\nbad\n");
+	json_ndjson_parser parser(2);
+	string out;
+	CHECK(parser.parse_file(path, [&](size_t line, json_node<>* n) { out += to_string(line) + ":" + print_or_null(n) + " "; return true; }));
+	CHECK(out == "0:{\"a\":1} 2:[2] 3:(null) " && parser.errors() == 1);
+	remove(path.c_str());
+	CHECK(!parser.parse_file(path, [](size_t, json_node<>*) { return true; }));
+	CHECK(json_parse_ndjson("").empty() && json_parse_ndjson("\n\n").empty());
+}
+
+//トップレベルのコンテナを分割した読み込み
+static string parallel_or_null(const string& s, const unsigned threads) { return print_or_null(json_parse_parallel(s.data(), s.size(), threads, 0)); }
+
+static void test_parse_parallel() {
+	check_rng r(13);
+	const size_t seeds = sizeof(check_seeds) / sizeof(check_seeds[0]);
+	//区切りの,や括弧を含む文字列・キー、重複したキーを含む大きな配列とオブジェクト
+	string array = "[", object = "{";
+	for (int i = 0; i < 2000; ++i) {
+		if (i) { array += ","; object += ",\n"; }
+		array += check_seeds[r.below(seeds)];
+		object += "\"k" + to_string(r.below(1500)) + (i % 7 == 0 ? ",}]\\\"" : "") + "\" : " + check_seeds[r.below(seeds)];
+	}
+	array += "]";
+	object += "}";
+	const unsigned threads[] = { 2, 3, 8 };
+	for (const unsigned t : threads) {
+		CHECK(parallel_or_null(array, t) == print_or_null(json_parse(array)));
+		CHECK(parallel_or_null(object, t) == print_or_null(json_parse(object)));
+		CHECK(parallel_or_null("\xEF\xBB\xBF [] ", t) == "[]" && parallel_or_null("{}", t) == "{}" && parallel_or_null(" 42 ", t) == "42");
+	}
+	//1MB未満は通常の読み込みと同じ
+	CHECK(print_or_null(json_parse_parallel(object, 4)) == print_or_null(json_parse(object)));
+
+	//変異させた入力は厳密な読み込み(json_parser)と受理・拒否が一致する
+	json_parser parser;
+	string medium = "[";
+	for (int i = 0; i < 50; ++i) medium += string(i ? "," : "") + check_seeds[i % seeds];
+	medium += "]";
+	for (int i = 0; i < 3000; ++i) {
+		const string s = mutate(r, r.below(2) ? medium : "{\"a\":" + medium + ",\"b\":[1,2,3],\"c\":{\"d\":[]}}");
+		json_parse_result res = parser.parse(s);
+		const string got = parallel_or_null(s, 1 + (unsigned)r.below(4));
+		if (res) CHECK(got == print_or_null(res.node));
+		else CHECK(got == "(null)" || res.error == json_error_trailing);
+		if (g_failed > 0) { printf("parallel: %s\n", s.c_str()); return; }
+	}
+	CHECK(parallel_or_null("[1,]", 2) == "(null)" && parallel_or_null("[,1]", 2) == "(null)" && parallel_or_null("[1,2] x", 2) == "(null)");
+	CHECK(parallel_or_null("{\"a\":1,}", 2) == "(null)" && parallel_or_null("{\"a\" 1}", 2) == "(null)" && parallel_or_null("[1,2", 2) == "(null)");
+}
+
+//複数スレッドでの書き出し
+static void test_print_parallel() {
+	json_node<>* big = large_document();
+	//先頭の範囲が空になるように要素を削除
+	for (int i = 0; i < 400; ++i) delete &(*big)[i];
+	delete &(*big)[1000];
+	json_node<>* wrapped = json_parse("{\"small\":[1,2],\"inner\":{\"deep\":null}}");
+	(*wrapped)["inner"].set_object("deep", big->clone()); //要素の多いコンテナを子孫に持つ
+	json_object<>* wide = new json_object<>;
+	for (int i = 0; i < 1000; ++i) wide->emplace_object<json_string<>>("key" + to_string(i), "v\"" + to_string(i));
+	wrapped->set_object("wide", wide);
+	json_document doc;
+	json_node<>* lazy = doc.parse_lazy(wrapped->print(0));
+	//要素の多いコンテナが多数ある(同じスレッドで順に出力し、範囲ごとの出力量も偏る)
+	json_array<>* many = new json_array<>;
+	for (int i = 0; i < 40; ++i) {
+		json_array<>* a = many->emplace_array<json_array<>>();
+		for (int j = 0; j < 256 + i * 7; ++j) {
+			if (j % 97 == 0) a->emplace_array<json_string<>>(string(j * 10, 'x'));
+			else a->emplace_array<json_number<>>(i * 1000 + j);
+		}
+	}
+
+	const int indents[] = { -1, 0, 1, 2 };
+	const unsigned threads[] = { 1, 2, 5 };
+	for (json_node<>* n : { big, wrapped, lazy, (json_node<>*)many }) {
+		for (const int indent : indents) {
+			const string expect = n->print(indent, " ");
+			for (const unsigned t : threads) {
+				CHECK(n->print_parallel(indent, " ", t) == expect);
+				string out;
+				json_callback_sink cb([&](const char* p, size_t len) { out.append(p, len); return true; });
+				CHECK(n->print_to_parallel(cb, indent, " ", t) && out == expect);
+			}
+		}
+	}
+	//読み込み前のコンテナは各スレッドが出力時に読み込む(入れ子も遅延読み込み)
+	string text = "[";
+	for (int i = 0; i < 4000; ++i) text += (i ? ",{\"a\":[" : "{\"a\":[") + to_string(i) + ",{\"b\":[\"" + to_string(i) + "\"]}]}";
+	text += "]";
+	json_node<>* heap = json_parse(text);
+	json_node<>* heap_wrapped = json_parse("{\"x\":" + text + "}");
+	for (const int indent : indents) {
+		const string expect = heap->print(indent, " "), expect_wrapped = heap_wrapped->print(indent, " ");
+		for (const unsigned t : threads) {
+			json_document ldoc;
+			CHECK(ldoc.parse_lazy(text)->print_parallel(indent, " ", t) == expect);
+			json_document sdoc;
+			string out;
+			json_callback_sink cb([&](const char* p, size_t len) { out.append(p, len); return true; });
+			CHECK(sdoc.parse_lazy("{\"x\":" + text + "}")->print_to_parallel(cb, indent, " ", t) && out == expect_wrapped);
+		}
+	}
+	delete heap;
+	delete heap_wrapped;
+
+	size_t calls = 0;
+	json_callback_sink fail([&](const char*, size_t) { ++calls; return false; });
+	CHECK(!wrapped->print_to_parallel(fail, 1, "\t", 4) && calls == 1);
+	delete big;
+	delete wrapped;
+	delete many;
+}
+
+//遅延読み込み
+static bool is_materialized(json_node<>& n) {
+	json_lazy<>* l = dynamic_cast<json_lazy<>*>(&n);
+	return l == nullptr || l->materialized();
+}
+
+static void test_lazy() {
+	json_document doc;
+	const string text = "{\"user\":{\"id\":7,\"tags\":[\"a\",{\"b\":[]}]},\"items\":[[1,2],[3]],\"skip\":{\"deep\":{\"x\":\"}]\\\"\"}},\"n\":1}";
+	json_node<>* root = doc.parse_lazy(text);
+	CHECK(root != nullptr && root->type() == Object && !is_materialized(*root));
+	//参照したコンテナの直下だけを読み込む
+	CHECK((*root)["user"]["id"].get_int() == 7);
+	CHECK(is_materialized(*root) && is_materialized((*root)["user"]));
+	CHECK(!is_materialized((*root)["user"]["tags"]) && !is_materialized((*root)["skip"]) && !is_materialized((*root)["items"]));
+	CHECK((*root)["items"].size() == 2 && (*root)["items"][1][0].get_int() == 3 && !is_materialized((*root)["items"][0]));
+	CHECK((*root)["skip"]["deep"]["x"].get_string() == "}]\"" && (*root)["missing"].type() == Null && (*root)["user"]["tags"][9].type() == Null);
+	CHECK(root->print(0) == print_or_null(json_parse(text)));
+
+	//読み込み後の変更は出力・複製に反映される
+	(*root)["items"][0].add_array(new json_number<>(9));
+	(*root)["user"].set_object("id", new json_string<>("changed"));
+	root->delete_object("skip");
+	const string edited = "{\"user\":{\"id\":\"changed\",\"tags\":[\"a\",{\"b\":[]}]},\"items\":[[1,2,9],[3]],\"n\":1}";
+	CHECK(root->print(0) == edited && print_or_null(root->clone()) == edited);
+
+	//入れ子のコンテナの文法エラーは参照するまで検出されず、空のコンテナとして扱う
+	root = doc.parse_lazy("{\"a\":{\"b\":[1,]},\"c\":2,\"d\":[{\"x\" 1}]}");
+	CHECK(root != nullptr && (*root)["c"].get_int() == 2);
+	CHECK((*root)["a"]["b"].size() == 0 && (*root)["a"]["b"][0].type() == Null && dynamic_cast<json_lazy<>&>((*root)["a"]["b"]).failed());
+	CHECK(root->print(0) == "{\"a\":{\"b\":[]},\"c\":2,\"d\":[{}]}" && print_or_null(root->clone()) == root->print(0));
+	CHECK((*root)["a"]["b"].emplace_array<json_number<>>(1) == nullptr);
+
+	//トップレベルの括弧の対応と末尾は読み込み時に検出する
+	CHECK(doc.parse_lazy("{\"a\":[1,2}") == nullptr && doc.parse_lazy("[1] x") == nullptr && doc.parse_lazy("") == nullptr);
+	CHECK(print_or_null(doc.parse_lazy("  \"str\"  ")->clone()) == "\"str\"");
+}
+
+//クエリ
+static string query_tree(const json_query& q, json_node<>* root) {
+	vector<json_node<>*> found;
+	q.find_all(root, found);
+	string out;
+	for (json_node<>* n : found) out += n->print(0) + " ";
+	return out;
+}
+
+static string query_text(const json_query& q, const string& text) {
+	string out;
+	if (!q.extract(text, [&out](json_node<>* n) { out += print_or_null(n) + " "; return true; })) return "(error)";
+	return out;
+}
+
+static void test_query() {
+	const string text = "{\"items\":[{\"id\":1,\"tags\":[\"a\",\"b\"]},{\"id\":\"two\",\"x\":{\"id\":3}},[],{\"tags\":[]}],"
+		"\"a/b\":{\"m~n\":true},\"key.with.dot\":[null,{\"\":0}],\"e\\u0073c\":\"\\\"\",\"n\":-1.5}";
+	json_node<>* root = json_parse(text);
+	struct { bool pointer; const char* expr; const char* expect; } cases[] = {
+		{ true, "", nullptr }, //全体
+		{ true, "/items/0/id", "1 " },
+		{ true, "/items/1/x/id", "3 " },
+		{ true, "/a~1b/m~0n", "true " },
+		{ true, "/key.with.dot/1/", "0 " },
+		{ true, "/esc", "\"\\\"\" " },
+		{ true, "/items/01", "" },
+		{ true, "/items/-", "" },
+		{ true, "/missing/x", "" },
+		{ true, "/n/0", "" },
+		{ false, "$.items[*].id", "1 \"two\" " },
+		{ false, "items[*].tags[*]", "\"a\" \"b\" " },
+		{ false, "items.*.*", "1 [\"a\",\"b\"] \"two\" {\"id\":3} [] " },
+		{ false, "[\"key.with.dot\"][1]", "{\"\":0} " },
+		{ false, "['a/b'].m~n", "true " },
+		{ false, "*", nullptr },
+		{ false, "items[1].id", "\"two\" " },
+		{ false, "items.1", "" }, //パス表記のキーは要素番号に一致しない
+		{ false, "n", "-1.5 " },
+	};
+	for (const auto& c : cases) {
+		const json_query q = c.pointer ? json_query::pointer(c.expr) : json_query::path(c.expr);
+		CHECK(q.valid());
+		const string tree = query_tree(q, root);
+		if (c.expect != nullptr) CHECK(tree == c.expect);
+		//入力テキストからの抽出は木の探索と同じ値を文書の順に返す
+		CHECK(query_text(q, text) == tree);
+	}
+	CHECK(query_tree(json_query::pointer(""), root) == root->print(0) + " ");
+	json_node<>* first = json_query::path("items[*].id").find(root);
+	CHECK(first != nullptr && first->get_int() == 1 && json_query::pointer("/nothing").find(root) == nullptr);
+	CHECK(print_or_null(json_query::path("$.items[*].id").extract_first(text)) == "1");
+
+	//不正なクエリ
+	const char* bad_pointers[] = { "a", "/~", "/a~2", "/~x" };
+	for (const char* p : bad_pointers) CHECK(!json_query::pointer(p).valid() && json_query::pointer(p).find(root) == nullptr);
+	const char* bad_paths[] = { "a..b", "a[", "a[x]", "a[01]", "[\"open]", "a.", "[-1]" };
+	for (const char* p : bad_paths) CHECK(!json_query::path(p).valid() && !json_query::path(p).extract(text, [](json_node<>*) { return true; }));
+
+	//抽出の中断と入力のエラー
+	size_t calls = 0;
+	CHECK(json_query::path("items[*]").extract(text, [&](json_node<>* n) { delete n; return ++calls < 2; }) && calls == 2);
+	CHECK(query_text(json_query::path("items[*].id"), "{\"items\":[{\"id\":1},{\"id\":}]}") == "(error)");
+	CHECK(query_text(json_query::path("a"), "{\"a\" 1}") == "(error)" && query_text(json_query::path("a"), "[1,2") == "(error)");
+	CHECK(query_text(json_query::path("a.b"), "{\"a\":5,\"z\":[]}") == "");
+	delete root;
+}
+
+//バイナリ形式
+static string hex_bytes(const char* hex) {
+	//"1b ff 00"のような16進数の列からバイト列を作成
+	string out;
+	for (const char* p = hex; *p; ++p) {
+		if (*p == ' ') continue;
+		out += (char)(_json_hex1(p[0]) << 4 | _json_hex1(p[1]));
+		++p;
+	}
+	return out;
+}
+
+static string to_cbor_text(const char* json) {
+	json_node<>* n = json_parse(json);
+	const string out = json_to_cbor(n);
+	delete n;
+	return out;
+}
+
+static string to_msgpack_text(const char* json) {
+	json_node<>* n = json_parse(json);
+	const string out = json_to_msgpack(n);
+	delete n;
+	return out;
+}
+
+static void test_binary() {
+	//CBORの書き出し(整数は最短の長さ、浮動小数点数は精度を落とさない範囲で短い形式)
+	struct { const char* json; const char* hex; } cbor[] = {
+		{ "0", "00" }, { "23", "17" }, { "24", "18 18" }, { "255", "18 ff" }, { "256", "19 01 00" }, { "65536", "1a 00 01 00 00" },
+		{ "4294967296", "1b 00 00 00 01 00 00 00 00" }, { "18446744073709551615", "1b ff ff ff ff ff ff ff ff" },
+		{ "-1", "20" }, { "-24", "37" }, { "-25", "38 18" }, { "-9223372036854775808", "3b 7f ff ff ff ff ff ff ff" },
+		{ "1.5", "fa 3f c0 00 00" }, { "0.1", "fb 3f b9 99 99 99 99 99 9a" }, { "-0.0", "fa 80 00 00 00" },
+		{ "\"a\"", "61 61" }, { "[]", "80" }, { "{}", "a0" }, { "true", "f5" }, { "false", "f4" }, { "null", "f6" },
+		{ "{\"a\":[1,{\"b\":null}]}", "a1 61 61 82 01 a1 61 62 f6" },
+	};
+	for (const auto& c : cbor) {
+		CHECK(to_cbor_text(c.json) == hex_bytes(c.hex));
+		CHECK(print_or_null(json_from_cbor(hex_bytes(c.hex))) == print_or_null(json_parse(c.json)));
+	}
+	//CBORの読み込み(半精度・タグ・不定長・バイト列・整数のキー)
+	struct { const char* hex; const char* json; } cbor_in[] = {
+		{ "f9 3c 00", "1.0" }, { "f9 7b ff", "65504.0" }, { "f9 00 01", "5.960464477539063e-8" }, { "f9 80 00", "-0.0" }, { "f9 7c 00", "null" },
+		{ "c1 1a 5f 5e 10 00", "1600000000" }, { "d8 20 63 61 62 63", "\"abc\"" },
+		{ "9f 01 9f ff 02 ff", "[1,[],2]" }, { "7f 61 61 62 62 63 ff", "\"abc\"" }, { "bf 61 61 01 ff", "{\"a\":1}" },
+		{ "42 68 69", "\"hi\"" }, { "a2 01 02 20 03", "{\"1\":2,\"-1\":3}" }, { "3b ff ff ff ff ff ff ff ff", "-1.8446744073709552e+19" },
+		{ "f7", "null" },
+	};
+	for (const auto& c : cbor_in) CHECK(print_or_null(json_from_cbor(hex_bytes(c.hex))) == c.json);
+	const char* cbor_bad[] = { "", "19 01", "ff", "9f 01", "7f 41 61 ff", "7f 7f ff ff", "a1 80 01", "01 01", "1c", "9b ff ff ff ff ff ff ff ff",
+		"f8 20", "bf 61 61", "a1 61 61", "62 61", "5f 61 61 ff", "c1" };
+	for (const char* b : cbor_bad) CHECK(json_from_cbor(hex_bytes(b)) == nullptr);
+
+	//MessagePackの書き出し
+	struct { const char* json; const char* hex; } msgpack[] = {
+		{ "127", "7f" }, { "128", "cc 80" }, { "256", "cd 01 00" }, { "65536", "ce 00 01 00 00" }, { "4294967296", "cf 00 00 00 01 00 00 00 00" },
+		{ "-1", "ff" }, { "-32", "e0" }, { "-33", "d0 df" }, { "-129", "d1 ff 7f" }, { "-32769", "d2 ff ff 7f ff" },
+		{ "-9223372036854775808", "d3 80 00 00 00 00 00 00 00" }, { "1.5", "ca 3f c0 00 00" }, { "0.1", "cb 3f b9 99 99 99 99 99 9a" },
+		{ "null", "c0" }, { "true", "c3" }, { "false", "c2" }, { "\"a\"", "a1 61" }, { "{\"a\":[]}", "81 a1 61 90" },
+	};
+	for (const auto& c : msgpack) {
+		CHECK(to_msgpack_text(c.json) == hex_bytes(c.hex));
+		CHECK(print_or_null(json_from_msgpack(hex_bytes(c.hex))) == print_or_null(json_parse(c.json)));
+	}
+	//長さの境界
+	json_array<> a;
+	for (int i = 0; i < 16; ++i) a.emplace_array<json_string<>>(string(17 + i, 'x')); //31バイトまでfixstr
+	const string packed = json_to_msgpack(&a);
+	CHECK(packed.compare(0, 3, hex_bytes("dc 00 10")) == 0 && packed.find(hex_bytes("bf") + string(31, 'x')) != string::npos && packed.find(hex_bytes("d9 20") + string(32, 'x')) != string::npos);
+	CHECK(print_or_null(json_from_msgpack(packed)) == a.print(0) && print_or_null(json_from_cbor(json_to_cbor(&a))) == a.print(0));
+	struct { const char* hex; const char* json; } msgpack_in[] = {
+		{ "c4 02 68 69", "\"hi\"" }, { "82 01 02 d0 ff 03", "{\"1\":2,\"-1\":3}" }, { "dd 00 00 00 01 c3", "[true]" }, { "de 00 01 a1 61 c0", "{\"a\":null}" },
+		{ "da 00 01 7a", "\"z\"" }, { "cc ff", "255" }, { "d1 80 00", "-32768" },
+	};
+	for (const auto& c : msgpack_in) CHECK(print_or_null(json_from_msgpack(hex_bytes(c.hex))) == c.json);
+	const char* msgpack_bad[] = { "", "c1", "d4 01 02", "c7 01 01 02", "81 c0 01", "81 ca 3f c0 00 00 01", "81 90 01", "cd 01", "91", "01 01",
+		"dd ff ff ff ff", "a2 61", "81 a1 61" };
+	for (const char* b : msgpack_bad) CHECK(json_from_msgpack(hex_bytes(b)) == nullptr);
+}
+
+//テープ形式
+static void test_tape() {
+	json_tape t;
+	CHECK(t.parse("\xEF\xBB\xBF{\"a\":[1,-2,18446744073709551615,2.5],\"s\":\"x\\ny\\u00e9\",\"o\":{\"t\":true,\"f\":false,\"n\":null},\"e\":[]}"));
+	json_tape_view root = t.root();
+	CHECK(root.type() == Object && root.size() == 4);
+	CHECK(root["a"].type() == Array && root["a"].size() == 4);
+	CHECK(root["a"][0].get_int() == 1 && root["a"][1].get_int() == -2 && root["a"][2].get_uint() == UINT64_MAX && root["a"][3].get_number() == 2.5);
+	CHECK(root["s"].get_string() == "x\ny\xC3\xA9" && root["s"].string_size() == 5 && memcmp(root["s"].string_data(), "x\ny", 3) == 0);
+	CHECK(root["o"]["t"].get_bool() && !root["o"]["f"].get_bool() && root["o"]["n"].type() == Null);
+	CHECK(root["e"].type() == Array && root["e"].size() == 0 && root["e"][0].type() == None);
+	CHECK(root["missing"].type() == None && root["a"][4].type() == None && root["s"]["x"].type() == None);
+	//コンテナの次の位置は終端の次
+	CHECK(json_tape_view(&t, root["a"].next()).type() == String);
+	CHECK(print_or_null(root["o"].to_node()) == "{\"t\":true,\"f\":false,\"n\":null}");
+
+	//失敗した場合は空のテープ
+	CHECK(!t.parse("{\"a\":[1,2}") && t.empty() && t.root().type() == None);
+	CHECK(!t.parse("") && !t.parse("[1,]") && !t.parse("{\"a\" 1}") && !t.parse("\"open"));
+	CHECK(t.parse("  42  ") && t.root().get_int() == 42 && t.tape_size() == 2);
+	t.clear();
+	CHECK(t.empty() && t.tape_size() == 0);
+}
+
+//文字列のエスケープ処理
+static string unescape_or_error(const string& json) {
+	size_t pos = 0;
+	string out;
+	return _json_unescape(json.data(), json.size(), pos, out) && pos == json.size() ? out : "(error)";
+}
+
+static void test_escape() {
+	check_rng r(4);
+	static const char alphabet[] = "\"\\/\b\f\n\r\t\x01\x1F abc\xC3\xA9\x7F";
+	string text, encoded;
+	for (int i = 0; i < 5000; ++i) {
+		//長い無変換の範囲と変換が必要な文字を混在させる
+		text.clear();
+		const size_t parts = r.below(8);
+		for (size_t k = 0; k < parts; ++k) {
+			text.append(r.below(80), (char)('a' + r.below(26)));
+			text += alphabet[r.below(sizeof(alphabet) - 1)];
+		}
+		for (size_t pos = 0; pos <= text.size(); ++pos) {
+			for (int slash = 0; slash < 2; ++slash) {
+				const size_t e = _json_scan_string_scalar(text.data(), pos, text.size(), slash != 0);
+#ifdef _JSON_X86
+				CHECK(_json_scan_string_sse2(text.data(), pos, text.size(), slash != 0) == e);
+				if (json_simd_level() >= 2) CHECK(_json_scan_string_avx2(text.data(), pos, text.size(), slash != 0) == e);
+#endif
+				CHECK(_json_scan_string(text.data(), pos, text.size(), slash != 0) == e);
+			}
+		}
+		encoded.clear();
+		_json_escape_encode(text, encoded);
+		CHECK(encoded.find_first_of("\x01\x1F\n\t") == string::npos);
+		CHECK(unescape_or_error(encoded + "\"") == text);
+	}
+
+	string out;
+	_json_escape_encode(string("a\"b\\c/d\x01\x1F\x7F", 10), out);
+	CHECK(out == "a\\\"b\\\\c\\/d\\u0001\\u001f\x7F");
+	CHECK(unescape_or_error("\\u0041\\u00e9\\u20ac\\ud83d\\ude00\\uDBFF\\uDFFF\"") == "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\xF4\x8F\xBF\xBF");
+	CHECK(unescape_or_error("\\b\\f\\n\\r\\t\\/\\\\\\\"\"") == "\b\f\n\r\t/\\\"");
+	CHECK(unescape_or_error("\\u0000\"") == string(1, '\0'));
+	//対にならないサロゲートはそのまま変換する
+	CHECK(unescape_or_error("\\ud83dx\"") == "\xED\xA0\xBDx");
+	CHECK(unescape_or_error("\\ud83d\\u0041\"") == "\xED\xA0\xBD" "A");
+	CHECK(unescape_or_error("abc") == "(error)" && unescape_or_error("\\u12G4\"") == "(error)");
+	CHECK(unescape_or_error("\\u12\"") == "(error)" && unescape_or_error("\\x\"") == "(error)");
+	CHECK(unescape_or_error("a\nb\"") == "(error)" && unescape_or_error("\\") == "(error)");
+}
+
+//数値の書き出しと読み込み
+static string number_text(const double d) {
+	char buf[32];
+	return string(buf, _json_dtoa(d, buf));
+}
+
+static bool parse_numval(const string& s, _json_numval& v) {
+	size_t pos = 0;
+	return _json_parse_number(s, pos, v) && pos == s.size();
+}
+
+static void test_numbers() {
+	check_rng r(5);
+	_json_numval v;
+	for (int i = 0; i < 200000; ++i) {
+		//任意のbit列のdoubleは書き出して読み直すと同じ値になる
+		uint64_t bits = r.next();
+		if (((bits >> 52) & 0x7FF) == 0x7FF) continue;
+		double d;
+		memcpy(&d, &bits, sizeof(d));
+		const string s = number_text(d);
+		CHECK(s.size() <= 25 && parse_numval(s, v) && v.kind == 'd' && memcmp(&v.d, &d, sizeof(d)) == 0);
+	}
+	for (int i = 0; i < 200000; ++i) {
+		//任意の10進数はstrtodと同じ値に変換する(19桁を超える仮数、範囲外の指数を含む)
+		string s = r.below(2) ? "-" : "";
+		const size_t digits = 1 + r.below(r.below(4) ? 19 : 30);
+		s += (char)('1' + r.below(9));
+		for (size_t k = 1; k < digits; ++k) s += (char)('0' + r.below(10));
+		if (r.below(2)) s.insert(s.size() - r.below(digits), ".");
+		if (s.back() == '.') s += '0';
+		s += "e" + to_string((int)r.below(700) - 350);
+		const double expect = strtod(s.c_str(), nullptr);
+		CHECK(parse_numval(s, v) && v.kind == 'd' && memcmp(&v.d, &expect, sizeof(expect)) == 0);
+	}
+
+	//最短の表記
+	CHECK(number_text(0.1) == "0.1" && number_text(5e-324) == "5e-324" && number_text(1e21) == "1e+21");
+	CHECK(number_text(-0.0) == "-0.0" && number_text(1e-9) == "1e-9" && number_text(100.0) == "100.0");
+	CHECK(number_text(0.30000000000000004) == "0.30000000000000004" && number_text(1.7976931348623157e308) == "1.7976931348623157e+308");
+	CHECK(number_text(123456789012345.0) == "123456789012345.0" && number_text(0.00001) == "0.00001");
+	//整数は int64 / uint64 で正確に保持
+	CHECK(parse_numval("9223372036854775807", v) && v.kind == 'i' && v.i == INT64_MAX);
+	CHECK(parse_numval("-9223372036854775808", v) && v.kind == 'i' && v.i == INT64_MIN);
+	CHECK(parse_numval("9223372036854775808", v) && v.kind == 'u' && v.u == (uint64_t)INT64_MAX + 1);
+	CHECK(parse_numval("18446744073709551615", v) && v.kind == 'u' && v.u == UINT64_MAX);
+	CHECK(parse_numval("18446744073709551616", v) && v.kind == 'd' && v.d == 18446744073709551616.0);
+	CHECK(parse_numval("-9223372036854775809", v) && v.kind == 'd');
+	CHECK(parse_numval("-0", v) && v.kind == 'd' && v.to_string() == "-0.0");
+	CHECK(parse_numval("1e2", v) && v.kind == 'd' && v.to_string() == "100.0");
+	CHECK(print_or_null(json_parse("[1234567890123456789,-1,18446744073709551615]")) == "[1234567890123456789,-1,18446744073709551615]");
+	//不正な数値
+	CHECK(!parse_numval("01", v) && !parse_numval("1.", v) && !parse_numval(".5", v) && !parse_numval("1e", v));
+	CHECK(!parse_numval("-", v) && !parse_numval("+1", v) && !parse_numval("1e+", v));
+	CHECK(parse_numval("1e999", v) && v.d == HUGE_VAL && parse_numval("1e-999", v) && v.d == 0);
+
+	//範囲外の整数の取得は上限・下限に丸める(小数部は切り捨て)
+	const string range = "[1e300,-1e300,1e999,-1,2.9,-2.9,18446744073709551615,-9223372036854775808,1e19]";
+	const int64_t ints[] = { INT64_MAX, INT64_MIN, INT64_MAX, -1, 2, -2, INT64_MAX, INT64_MIN, INT64_MAX };
+	const uint64_t uints[] = { UINT64_MAX, 0, UINT64_MAX, 0, 2, 0, UINT64_MAX, 0, 10000000000000000000ULL };
+	json_node<>* n = json_parse(range);
+	json_value jv;
+	json_tape t;
+	CHECK(n != nullptr && json_value::parse(range, jv) && t.parse(range));
+	for (size_t i = 0; i < sizeof(ints) / sizeof(ints[0]); ++i) {
+		CHECK((*n)[i].get_int() == ints[i] && jv[i].get_int() == ints[i] && t.root()[i].get_int() == ints[i]);
+		CHECK((*n)[i].get_uint() == uints[i] && jv[i].get_uint() == uints[i] && t.root()[i].get_uint() == uints[i]);
+	}
+	delete n;
+	json_number<> nan(NAN);
+	json_string<> huge("1e300");
+	CHECK(nan.get_int() == 0 && nan.get_uint() == 0 && huge.get_int() == INT64_MAX && huge.get_uint() == UINT64_MAX);
+}
+
+//SAX形式の読み込み
+struct check_sax_log : json_sax_handler<check_sax_log> {
+	std::string log;
+	size_t limit = SIZE_MAX; //イベント数の上限(超えると中断)
+	size_t events = 0;
+	bool add(const std::string& e) { log += e; log += ' '; return ++events < limit; }
+	bool start_object() { return add("{"); }
+	bool key(const std::string& k) { return add("k:" + k); }
+	bool end_object() { return add("}"); }
+	bool start_array() { return add("["); }
+	bool end_array() { return add("]"); }
+	bool number(const double v) { return add("d:" + number_text(v)); }
+	bool integer(const int64_t v) { return add("i:" + to_string(v)); }
+	bool uinteger(const uint64_t v) { return add("u:" + to_string(v)); }
+	bool boolean(const bool v) { return add(v ? "true" : "false"); }
+	bool null() { return add("null"); }
+	bool string(const std::string& v) { return add("s:" + v); }
+};
+
+struct check_sax_raw : json_sax_handler<check_sax_raw> {
+	static const bool raw_strings = true;
+	std::string log;
+	bool string_ref(const char* p, const size_t n, const bool escaped) { log += std::string(p, n) + (escaped ? "(e) " : " "); return true; }
+	bool key(const std::string& k) { log += "k:" + k + " "; return true; }
+};
+
+struct check_sax_sum : json_sax_handler<check_sax_sum> {
+	double sum = 0;
+	bool number(const double v) { sum += v; return true; }
+};
+
+static void test_sax() {
+	check_sax_log h;
+	CHECK(json_sax_parse("\xEF\xBB\xBF{\"a\":[1,-2,18446744073709551615,2.5,\"x\\ny\"],\"b\":{\"c\":true,\"d\":false,\"e\":null},\"f\":[]}", h));
+	CHECK(h.log == "{ k:a [ i:1 i:-2 u:18446744073709551615 d:2.5 s:x\ny ] k:b { k:c true k:d false k:e null } k:f [ ] } ");
+
+	//integer, uintegerを定義しない場合はnumberが呼ばれる
+	check_sax_sum sum;
+	CHECK(json_sax_parse("[1,2.5,{\"x\":18446744073709551615}]", sum) && sum.sum == 3.5 + 18446744073709551615.0);
+
+	//文字列の値を変換せずに受け取る(キーは変換される)
+	check_sax_raw raw;
+	CHECK(json_sax_parse("{\"k\\\"\":[\"plain\",\"e\\u0041\"]}", raw) && raw.log == "k:k\" plain e\\u0041(e) ");
+
+	//ハンドラがfalseを返すと中断する
+	for (size_t limit = 1; limit <= 5; ++limit) {
+		check_sax_log stop;
+		stop.limit = limit;
+		CHECK(!json_sax_parse("{\"a\":[1,2],\"b\":3}", stop) && stop.events == limit);
+	}
+	check_sax_log stop;
+	stop.limit = 2;
+	json_parser parser;
+	json_parse_result r = parser.sax_parse("{\"a\":[1,2]}", stop);
+	CHECK(!r && r.error == json_error_handler && r.offset == 1);
+
+	//不正な入力ではイベントの途中で失敗する
+	check_sax_log bad;
+	CHECK(!json_sax_parse("[1,{\"a\":}]", bad) && bad.log == "[ i:1 { k:a ");
+	CHECK(!json_sax_parse("", bad) && !json_sax_parse("[1", bad) && !json_sax_parse("{\"a\" 1}", bad));
+
+	//DOMの構築と同じ文法
+	for (const char* seed : check_seeds) {
+		check_sax_log ok;
+		CHECK(json_sax_parse(seed, ok) && print_or_null(json_parse(seed)) != "(null)");
+	}
+}
+
+#ifdef JSON_STATS
+//統計情報(make CheckStatsでJSON_STATSを定義してビルド)
+static void test_stats() {
+	const string text = "{\"a\":[1,2.5,\"x\\n\"],\"b\":{\"c\":null,\"d\":true}}";
+	vector<string> ops;
+	json_stats_callback([&ops](const json_stats& s) { ops.push_back(s.op); });
+	json_node<>* n = json_parse(text);
+	const json_stats parsed = json_stats_last();
+	CHECK(string(parsed.op) == "parse" && parsed.bytes == text.size() && parsed.node_count() == 8);
+	CHECK(parsed.nodes[Object] == 2 && parsed.nodes[Array] == 1 && parsed.nodes[String] == 1 && parsed.nodes[Number] == 2 && parsed.nodes[Boolean] == 1 && parsed.nodes[Null] == 1);
+	CHECK(parsed.max_depth == 2 && parsed.escapes == 1 && parsed.allocs > 0 && parsed.alloc_bytes > 0 && parsed.ns_total > 0);
+
+	const string out = n->print(1);
+	const json_stats printed = json_stats_last();
+	CHECK(string(printed.op) == "print" && printed.bytes == out.size() && printed.node_count() == 8 && printed.max_depth == 2 && printed.escapes == 1);
+	string sunk;
+	json_callback_sink cb([&sunk](const char* p, size_t len) { sunk.append(p, len); return true; });
+	CHECK(n->print_to(cb, 0) && json_stats_last().bytes == sunk.size() && string(json_stats_last().op) == "print");
+	delete n;
+
+	json_parser parser;
+	json_parse_result r = parser.parse(nested(50));
+	CHECK(r && json_stats_last().max_depth == 50 && json_stats_last().nodes[Array] == 50);
+	delete r.node;
+	CHECK(ops == vector<string>({ "parse", "print", "print", "parse" }));
+	json_stats_callback(nullptr);
+
+	//統計情報はスレッドごと
+	thread([]() {
+		json_node<>* m = json_parse("[1]");
+		CHECK(json_stats_last().node_count() == 2);
+		delete m;
+	}).join();
+	CHECK(json_stats_last().max_depth == 50);
+}
+#endif
+
+int main(int argc, char* argv[]) {
+	const size_t iterations = argc > 1 ? (size_t)strtoull(argv[1], nullptr, 10) : 200000;
+	test_differential(iterations);
+	test_document();
+	test_file();
+	test_sink();
+	test_object_order();
+	test_key_table();
+	test_ndjson();
+	test_parse_parallel();
+	test_print_parallel();
+	test_lazy();
+	test_query();
+	test_binary();
+	test_parser_errors();
+	test_print_cached();
+	test_value_sharing();
+	test_frozen();
+	test_value_access();
+	test_tape();
+	test_escape();
+	test_numbers();
+	test_sax();
+	test_push_chunks();
+	test_push_depth();
+	test_tape_depth();
+	test_structural_index();
+	test_index_limit();
+	test_missing_element();
+	test_bind();
+	test_bind_range();
+	test_bind_depth();
+	test_depth_limits();
+#ifdef JSON_STATS
+	test_stats();
+#endif
+	printf("%d checks, %d failed\n", g_checks, g_failed);
+	return g_failed == 0 ? 0 : 1;
+}
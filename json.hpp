@@ -4,11 +4,52 @@
 #define _JSON_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <string>
 #include <vector>
 #include <map>
+#include <deque>
+#include <cstdio>
+#include <ostream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define _JSON_POSIX 1
+#else
+#include <fstream>
+#endif
 using namespace std;
 
+//インライン展開しない関数
+#if defined(__GNUC__) || defined(__clang__)
+#define _JSON_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define _JSON_NOINLINE __declspec(noinline)
+#else
+#define _JSON_NOINLINE
+#endif
+
 enum json_type {
 	None,
 	Object,
@@ -19,6 +60,343 @@ enum json_type {
 	Null
 };
 
+//読み込み・書き出しの統計情報(JSON_STATSを定義した場合のみ計測、未定義の場合は計測処理を含まない)
+//json_parse・print・print_toの呼び出しごとに集計する
+struct json_stats {
+	const char* op;       //"parse" または "print"
+	size_t bytes;         //読み込んだ・書き出したバイト数
+	size_t nodes[7];      //種類(json_type)ごとのノード数
+	size_t allocs;        //ノード・スロット・キー・アリーナのメモリ確保の回数
+	size_t alloc_bytes;   //確保したバイト数
+	size_t max_depth;     //コンテナの最大の深さ
+	size_t escapes;       //変換したエスケープシーケンスの数
+	uint64_t ns_total;    //全体の時間
+	uint64_t ns_strings;  //文字列の変換の時間(読み込み)
+	uint64_t ns_numbers;  //数値の変換の時間(読み込み)
+	uint64_t ns_write;    //書き出し先への出力の時間(書き出し)
+	size_t depth;         //現在の深さ(集計用)
+
+	json_stats() { clear(); }
+	void clear() { memset(this, 0, sizeof(*this)); op = ""; }
+	size_t node_count() const {
+		size_t n = 0;
+		for (size_t i = 0; i < 7; ++i) n += nodes[i];
+		return n;
+	}
+};
+
+//計測中の統計情報(スレッドごと)
+inline json_stats*& _json_stats_current() { static thread_local json_stats* s = nullptr; return s; }
+//直前の呼び出しの統計情報(スレッドごと)
+inline json_stats& json_stats_last() { static thread_local json_stats s; return s; }
+inline function<void(const json_stats&)>& _json_stats_callback() { static function<void(const json_stats&)> f; return f; }
+//呼び出しごとに統計情報を受け取る関数を登録(計測したスレッドで呼び出す、登録は計測前に行うこと)
+inline void json_stats_callback(function<void(const json_stats&)> f) { _json_stats_callback() = move(f); }
+inline uint64_t _json_stats_now() { return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count(); }
+
+//呼び出し単位の計測(入れ子の場合は外側に集計)
+class _json_stats_scope {
+	json_stats s_stats;
+	bool s_owner;
+	uint64_t s_start;
+public:
+	_json_stats_scope(const char* op) : s_owner(_json_stats_current() == nullptr), s_start(0) {
+		if (!s_owner) return;
+		s_stats.op = op;
+		_json_stats_current() = &s_stats;
+		s_start = _json_stats_now();
+	}
+	~_json_stats_scope() {
+		if (!s_owner) return;
+		s_stats.ns_total = _json_stats_now() - s_start;
+		_json_stats_current() = nullptr;
+		json_stats_last() = s_stats;
+		if (_json_stats_callback()) _json_stats_callback()(s_stats);
+	}
+	void bytes(const size_t n) { if (s_owner) s_stats.bytes = n; }
+};
+//区間の時間を加算
+class _json_stats_timer {
+	uint64_t* t_dest;
+	uint64_t t_start;
+public:
+	_json_stats_timer(uint64_t json_stats::* m) : t_dest(_json_stats_current() != nullptr ? &(_json_stats_current()->*m) : nullptr), t_start(t_dest != nullptr ? _json_stats_now() : 0) {}
+	~_json_stats_timer() { if (t_dest != nullptr) *t_dest += _json_stats_now() - t_start; }
+};
+
+#ifdef JSON_STATS
+#define _JSON_STAT(x) do { if (json_stats* _s = _json_stats_current()) { x; } } while (0)
+#define _JSON_STAT_TIMER(m) _json_stats_timer _json_timer_##m(&json_stats::m)
+#define _JSON_STAT_SCOPE(op) _json_stats_scope _json_scope(op)
+#define _JSON_STAT_BYTES(n) _json_scope.bytes(n)
+#define _JSON_STAT_ALLOC(n) _JSON_STAT(++_s->allocs; _s->alloc_bytes += (n))
+#define _JSON_STAT_ENTER(t) _JSON_STAT(++_s->nodes[t]; if (((t) == Object || (t) == Array) && ++_s->depth > _s->max_depth) _s->max_depth = _s->depth)
+#define _JSON_STAT_LEAVE(t) _JSON_STAT(if ((t) == Object || (t) == Array) --_s->depth)
+#else
+#define _JSON_STAT(x) ((void)0)
+#define _JSON_STAT_TIMER(m)
+#define _JSON_STAT_SCOPE(op)
+#define _JSON_STAT_BYTES(n) ((void)0)
+#define _JSON_STAT_ALLOC(n) ((void)0)
+#define _JSON_STAT_ENTER(t) ((void)0)
+#define _JSON_STAT_LEAVE(t) ((void)0)
+#endif
+
+//ノード確保用のバンプアロケータ(一括解放)
+class _json_arena {
+	struct chunk { chunk* next; size_t size; };
+	chunk* a_head;
+	char* a_pos;
+	char* a_end;
+	size_t a_next;
+	mutex a_lock;
+
+	static size_t align_up(size_t n, size_t a) { return (n + a - 1) & ~(a - 1); }
+public:
+	_json_arena(const size_t first = 64 * 1024) : a_head(nullptr), a_pos(nullptr), a_end(nullptr), a_next(first) {}
+	~_json_arena() { release(); }
+	_json_arena(const _json_arena&) = delete;
+	_json_arena& operator=(const _json_arena&) = delete;
+
+	void* allocate(const size_t size, const size_t align = alignof(max_align_t)) {
+		char* p = (char*)align_up((size_t)a_pos, align);
+		if (a_pos == nullptr || p + size > a_end) {
+			//新しいチャンクを確保(サイズは倍々で増加)
+			size_t csize = max(a_next, size + align + sizeof(chunk));
+			chunk* c = (chunk*)::operator new(csize);
+			_JSON_STAT_ALLOC(csize);
+			c->next = a_head; c->size = csize;
+			a_head = c;
+			a_pos = (char*)c + sizeof(chunk);
+			a_end = (char*)c + csize;
+			if (a_next < 16 * 1024 * 1024) a_next *= 2;
+			p = (char*)align_up((size_t)a_pos, align);
+		}
+		a_pos = p + size;
+		return p;
+	}
+	//複数スレッドから確保する場合の排他(並列出力中の遅延読み込み)
+	mutex& lock() { return a_lock; }
+	void release() {
+		//すべてのチャンクを解放
+		while (a_head != nullptr) {
+			chunk* c = a_head->next;
+			::operator delete(a_head);
+			a_head = c;
+		}
+		a_pos = a_end = nullptr;
+	}
+};
+
+//ノードの確保元(nullptrの場合はヒープ)
+union _json_node_header {
+	_json_arena* arena;
+	max_align_t align;
+};
+
+//ビット演算(GCC/Clang以外は移植版)
+inline int _json_ctz64(const uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	int n = 0;
+	while (((x >> n) & 1) == 0) ++n;
+	return n;
+#endif
+}
+inline int _json_clz64(const uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clzll(x);
+#else
+	int n = 0;
+	while (((x << n) >> 63) == 0) ++n;
+	return n;
+#endif
+}
+//64bit x 64bit = 128bit
+inline uint64_t _json_mul128(const uint64_t a, const uint64_t b, uint64_t& lo) {
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 r = (unsigned __int128)a * b;
+	lo = (uint64_t)r;
+	return (uint64_t)(r >> 64);
+#else
+	uint64_t a_lo = (uint32_t)a, a_hi = a >> 32, b_lo = (uint32_t)b, b_hi = b >> 32;
+	uint64_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+	uint64_t mid = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+	lo = (mid << 32) | (uint32_t)p0;
+	return p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+//SIMD(x86-64ではSSE2/AVX2を実行時に選択、それ以外はスカラー)
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define _JSON_X86 1
+#endif
+
+//64byteブロックの文字分類(各bitがブロック内の位置に対応)
+struct _json_block {
+	uint64_t quote; //"
+	uint64_t bs;    //バックスラッシュ
+	uint64_t ws;    //空白(スペース, \t, \n, \r)
+	uint64_t op;    //構造文字({ } [ ] : ,)
+};
+
+inline void _json_classify_scalar(const char* p, _json_block& b) {
+	b.quote = b.bs = b.ws = b.op = 0;
+	for (int i = 0; i < 64; ++i) {
+		uint64_t bit = 1ULL << i;
+		switch (p[i]) {
+			case '\"': b.quote |= bit; break;
+			case '\\': b.bs |= bit; break;
+			case ' ': case '\t': case '\n': case '\r': b.ws |= bit; break;
+			case '{': case '}': case '[': case ']': case ':': case ',': b.op |= bit; break;
+		}
+	}
+}
+
+#ifdef _JSON_X86
+inline void _json_classify_sse2(const char* p, _json_block& b) {
+	b.quote = b.bs = b.ws = b.op = 0;
+	for (int i = 0; i < 64; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+		uint64_t q = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')));
+		uint64_t s = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+		uint64_t w = (uint32_t)_mm_movemask_epi8(_mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))));
+		uint64_t o = (uint32_t)_mm_movemask_epi8(_mm_or_si128(
+			_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('{')), _mm_cmpeq_epi8(v, _mm_set1_epi8('}'))),
+				_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('[')), _mm_cmpeq_epi8(v, _mm_set1_epi8(']')))),
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(',')))));
+		b.quote |= q << i; b.bs |= s << i; b.ws |= w << i; b.op |= o << i;
+	}
+}
+
+__attribute__((target("avx2")))
+inline void _json_classify_avx2(const char* p, _json_block& b) {
+	b.quote = b.bs = b.ws = b.op = 0;
+	for (int i = 0; i < 64; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+		uint64_t q = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')));
+		uint64_t s = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+		uint64_t w = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')))));
+		uint64_t o = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+			_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('}'))),
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('[')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(']')))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')))));
+		b.quote |= q << i; b.bs |= s << i; b.ws |= w << i; b.op |= o << i;
+	}
+}
+#endif
+
+//利用するSIMDの種類(0=スカラー, 1=SSE2, 2=AVX2)
+inline int json_simd_level() {
+#ifdef _JSON_X86
+	static const int level = []() -> int {
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") ? 2 : 1;
+	}();
+	return level;
+#else
+	return 0;
+#endif
+}
+
+typedef void (*_json_classify_fn)(const char*, _json_block&);
+inline _json_classify_fn _json_classifier(const int level) {
+#ifdef _JSON_X86
+	if (level >= 2) return _json_classify_avx2;
+	if (level == 1) return _json_classify_sse2;
+#endif
+	return _json_classify_scalar;
+}
+
+//空白の読み飛ばし
+inline size_t _json_skip_ws(const char* p, size_t pos, const size_t n) {
+#ifdef _JSON_X86
+	//インデントなどの長い空白は16byteずつ判定
+	while (pos + 16 <= n) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(p + pos));
+		unsigned w = (unsigned)_mm_movemask_epi8(_mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))));
+		if (w != 0xFFFF) return pos + __builtin_ctz(~w);
+		pos += 16;
+	}
+#endif
+	while (pos < n && (p[pos] == ' ' || p[pos] == '\t' || p[pos] == '\n' || p[pos] == '\r')) ++pos;
+	return pos;
+}
+
+//構造インデックスの作成
+//文字列外の構造文字、文字列開始の"、数値やリテラルの先頭の位置を昇順に格納する
+//文字列が閉じられていない場合、位置が32bitに収まらない(4GiBを超える)場合はfalse
+//64バイト単位で文字列の範囲を判定(ブロック間の状態を保持)
+struct _json_stage1 {
+	_json_classify_fn classify;
+	_json_block b;
+	uint64_t quote; //エスケープされていない"
+	uint64_t in_string; //文字列の範囲(開始の"を含み、終了の"を含まない)
+	uint64_t escaped_carry, string_carry;
+	char last[64];
+
+	_json_stage1(const int level) : classify(_json_classifier(level)), quote(0), in_string(0), escaped_carry(0), string_carry(0) {}
+	void next(const char* p, const size_t base, const size_t n) {
+		if (base + 64 <= n) classify(p + base, b);
+		else {
+			//末尾は空白で埋めて判定
+			memset(last, ' ', sizeof(last));
+			memcpy(last, p + base, n - base);
+			classify(last, b);
+		}
+		//エスケープされた文字(奇数個のバックスラッシュの直後)
+		uint64_t escaped = escaped_carry, bs = b.bs & ~escaped_carry;
+		escaped_carry = 0;
+		while (bs != 0) {
+			int i = _json_ctz64(bs);
+			if (i == 63) escaped_carry = 1;
+			else {
+				escaped |= 1ULL << (i + 1);
+				bs &= ~(1ULL << (i + 1));
+			}
+			bs &= bs - 1;
+		}
+		quote = b.quote & ~escaped;
+		in_string = quote;
+		in_string ^= in_string << 1; in_string ^= in_string << 2; in_string ^= in_string << 4;
+		in_string ^= in_string << 8; in_string ^= in_string << 16; in_string ^= in_string << 32;
+		in_string ^= string_carry;
+		string_carry = (uint64_t)((int64_t)in_string >> 63);
+	}
+};
+
+inline bool json_structural_index(const char* p, const size_t n, vector<uint32_t>& index, const int level = json_simd_level()) {
+	index.clear();
+	if (n > (size_t)UINT32_MAX) return false;
+	_json_stage1 s(level);
+	uint64_t scalar_carry = 0;
+	index.reserve(n / 4 + 16);
+	for (size_t base = 0; base < n; base += 64) {
+		s.next(p, base, n);
+		const _json_block& b = s.b;
+		uint64_t quote = s.quote, in_string = s.in_string;
+		//数値・リテラルの先頭
+		uint64_t scalar = ~(b.op | b.ws | quote | in_string);
+		uint64_t bits = (b.op & ~in_string) | (quote & in_string) | (scalar & ~((scalar << 1) | scalar_carry));
+		scalar_carry = scalar >> 63;
+		while (bits != 0) {
+			size_t i = base + _json_ctz64(bits);
+			if (i >= n) break;
+			index.push_back((uint32_t)i);
+			bits &= bits - 1;
+		}
+	}
+	return s.string_carry == 0;
+}
+inline bool json_structural_index(const string& json, vector<uint32_t>& index, const int level = json_simd_level()) { return json_structural_index(json.data(), json.size(), index, level); }
+
 template <typename T> class json_object;
 template <typename T> class json_array;
 template <typename T> class json_string;
@@ -26,10 +404,68 @@ template <typename T> class json_number;
 template <typename T> class json_boolean;
 template <typename T> class json_null;
 
+//エスケープ処理が必要な文字(", \, 制御文字, slash=trueの場合は/)の検索
+inline size_t _json_scan_string_scalar(const char* p, size_t pos, const size_t n, const bool slash) {
+	for (; pos < n; ++pos) {
+		unsigned char c = (unsigned char)p[pos];
+		if (c == '\"' || c == '\\' || c < 0x20 || (slash && c == '/')) return pos;
+	}
+	return n;
+}
+
+#ifdef _JSON_X86
+inline size_t _json_scan_string_sse2(const char* p, size_t pos, const size_t n, const bool slash) {
+	const __m128i sl = _mm_set1_epi8(slash ? '/' : '\"');
+	while (pos + 16 <= n) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(p + pos));
+		__m128i m = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+			_mm_or_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F)), _mm_cmpeq_epi8(v, sl)));
+		unsigned bits = (unsigned)_mm_movemask_epi8(m);
+		if (bits != 0) return pos + __builtin_ctz(bits);
+		pos += 16;
+	}
+	return _json_scan_string_scalar(p, pos, n, slash);
+}
+
+__attribute__((target("avx2")))
+inline size_t _json_scan_string_avx2(const char* p, size_t pos, const size_t n, const bool slash) {
+	const __m256i sl = _mm256_set1_epi8(slash ? '/' : '\"');
+	while (pos + 32 <= n) {
+		__m256i v = _mm256_loadu_si256((const __m256i*)(p + pos));
+		__m256i m = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(0x1F)), _mm256_set1_epi8(0x1F)), _mm256_cmpeq_epi8(v, sl)));
+		unsigned bits = (unsigned)_mm256_movemask_epi8(m);
+		if (bits != 0) return pos + __builtin_ctz(bits);
+		pos += 32;
+	}
+	return _json_scan_string_sse2(p, pos, n, slash);
+}
+#endif
+
+typedef size_t (*_json_scan_fn)(const char*, size_t, const size_t, const bool);
+inline size_t _json_scan_string(const char* p, const size_t pos, const size_t n, const bool slash) {
+#ifdef _JSON_X86
+	static const _json_scan_fn fn = json_simd_level() >= 2 ? _json_scan_string_avx2 : json_simd_level() == 1 ? _json_scan_string_sse2 : _json_scan_string_scalar;
+	return fn(p, pos, n, slash);
+#else
+	return _json_scan_string_scalar(p, pos, n, slash);
+#endif
+}
+
 //通常文字列からJSON文字列へのエスケープ処理
-inline void _json_escape_encode(const string& text, string& out) {
-	for (char it : text) {
-		switch (it) {
+inline void _json_escape_encode(const char* text, const size_t n, string& out) {
+	static const char hex[] = "0123456789abcdef";
+	size_t pos = 0;
+	while (pos < n) {
+		//エスケープ不要な範囲はまとめてコピー
+		size_t e = _json_scan_string(text, pos, n, true);
+		out.append(text + pos, e - pos);
+		if (e >= n) break;
+		unsigned char c = (unsigned char)text[e];
+		_JSON_STAT(++_s->escapes);
+		switch (c) {
 			case '\"': out += "\\\""; break;
 			case '\\': out += "\\\\"; break;
 			case '/':  out += "\\/";  break;
@@ -38,214 +474,1913 @@ inline void _json_escape_encode(const string& text, string& out) {
 			case '\n': out += "\\n";  break;
 			case '\r': out += "\\r";  break;
 			case '\t': out += "\\t";  break;
-			default:   out += it;     break;
+			default: //その他の制御文字
+				out += "\\u00";
+				out += hex[c >> 4];
+				out += hex[c & 0xF];
+				break;
+		}
+		pos = e + 1;
+	}
+}
+inline void _json_escape_encode(const string& text, string& out) { _json_escape_encode(text.data(), text.size(), out); }
+
+//オブジェクトのキーのハッシュ値(8バイト単位で混合)
+inline uint32_t _json_hash_key(const char* p, size_t n) {
+	uint64_t h = 0x9E3779B97F4A7C15ULL ^ n;
+	while (n >= 8) {
+		uint64_t v;
+		memcpy(&v, p, 8);
+		h = (h ^ v) * 0xFF51AFD7ED558CCDULL;
+		h ^= h >> 32;
+		p += 8;
+		n -= 8;
+	}
+	//残り7バイト以下は重なりを許して固定長で読み込む
+	uint64_t v = 0;
+	if (n >= 4) {
+		uint32_t a, b;
+		memcpy(&a, p, 4);
+		memcpy(&b, p + n - 4, 4);
+		v = ((uint64_t)a << 32) | b;
+	} else if (n > 0) v = ((uint64_t)(unsigned char)p[0] << 16) | ((uint64_t)(unsigned char)p[n >> 1] << 8) | (unsigned char)p[n - 1];
+	h = (h ^ v) * 0xC4CEB9FE1A85EC53ULL;
+	h ^= h >> 29;
+	return (uint32_t)h ^ (uint32_t)(h >> 32);
+}
+
+//オブジェクトのキー(参照数で共有、アリーナ上のキーは参照数を使用しない)
+struct _json_key {
+	atomic<uint32_t> refs;
+	uint32_t hash;
+	uint32_t len;
+	bool arena;
+	const char* data; //通常はbufを指す(入力を参照するキーは入力上の位置で、終端の'\0'は無い)
+	char buf[1];
+};
+inline _json_key* _json_key_new(const char* p, const size_t n, const uint32_t hash, _json_arena* arena = nullptr) {
+	size_t size = offsetof(_json_key, buf) + n + 1;
+	void* mem = arena != nullptr ? arena->allocate(size, alignof(_json_key)) : malloc(size);
+	if (mem == nullptr) throw bad_alloc();
+	if (arena == nullptr) _JSON_STAT_ALLOC(size);
+	_json_key* k = new (mem) _json_key;
+	k->refs.store(1, memory_order_relaxed);
+	k->hash = hash;
+	k->len = (uint32_t)n;
+	k->arena = arena != nullptr;
+	memcpy(k->buf, p, n);
+	k->buf[n] = '\0';
+	k->data = k->buf;
+	return k;
+}
+//入力を参照するキーをアリーナに作成(入力はアリーナより長く保持すること)
+inline _json_key* _json_key_view(const char* p, const size_t n, const uint32_t hash, _json_arena* arena) {
+	_json_key* k = new (arena->allocate(sizeof(_json_key), alignof(_json_key))) _json_key;
+	k->refs.store(1, memory_order_relaxed);
+	k->hash = hash;
+	k->len = (uint32_t)n;
+	k->arena = true;
+	k->data = p;
+	return k;
+}
+inline void _json_key_ref(_json_key* k) { if (!k->arena) k->refs.fetch_add(1, memory_order_relaxed); }
+inline void _json_key_release(_json_key* k) {
+	if (k->arena || k->refs.fetch_sub(1, memory_order_acq_rel) != 1) return;
+	k->~_json_key();
+	free(k);
+}
+
+//文字列の参照(std::string_viewの代わり、参照先より長く保持しないこと)
+class json_string_view {
+	const char* s_ptr;
+	size_t s_len;
+public:
+	json_string_view() : s_ptr(""), s_len(0) {}
+	json_string_view(const char* p, const size_t n) : s_ptr(p), s_len(n) {}
+	json_string_view(const char* p) : s_ptr(p), s_len(strlen(p)) {}
+	json_string_view(const string& str) : s_ptr(str.data()), s_len(str.size()) {}
+
+	const char* data() const { return s_ptr; }
+	size_t size() const { return s_len; }
+	bool empty() const { return s_len == 0; }
+	const char* begin() const { return s_ptr; }
+	const char* end() const { return s_ptr + s_len; }
+	char operator[](const size_t num) const { return s_ptr[num]; }
+	string str() const { return string(s_ptr, s_len); }
+	bool operator==(const json_string_view& o) const { return s_len == o.s_len && memcmp(s_ptr, o.s_ptr, s_len) == 0; }
+	bool operator!=(const json_string_view& o) const { return !(*this == o); }
+};
+
+//検索・追加に使用するキー(キー表で作成したものはポインタの比較で一致を判定できる)
+class json_key {
+	_json_key* k;
+public:
+	json_key() : k(nullptr) {}
+	explicit json_key(const char* p, const size_t n) : k(_json_key_new(p, n, _json_hash_key(p, n))) {}
+	explicit json_key(const string& str) : json_key(str.data(), str.size()) {}
+	json_key(_json_key* p, const bool addref) : k(p) { if (k != nullptr && addref) _json_key_ref(k); }
+	json_key(const json_key& o) : k(o.k) { if (k != nullptr) _json_key_ref(k); }
+	json_key(json_key&& o) : k(o.k) { o.k = nullptr; }
+	~json_key() { if (k != nullptr) _json_key_release(k); }
+	json_key& operator=(json_key o) { swap(k, o.k); return *this; }
+
+	_json_key* get() const { return k; }
+	bool empty() const { return k == nullptr; }
+	const char* data() const { return k != nullptr ? k->data : ""; }
+	size_t size() const { return k != nullptr ? k->len : 0; }
+	string str() const { return string(data(), size()); }
+	bool operator==(const json_key& o) const { return k == o.k || (size() == o.size() && memcmp(data(), o.data(), size()) == 0); }
+	bool operator!=(const json_key& o) const { return !(*this == o); }
+};
+
+//キーの共有表(同じスキーマの文書を大量に読み込む場合にキーを1つにまとめる)
+//複数のスレッドから同時に使用しないこと
+class json_key_table {
+	vector<_json_key*> t_slots; //オープンアドレス法
+	size_t t_count;
+	size_t t_limit; //登録数の上限(0は無制限)
+
+	void grow() {
+		vector<_json_key*> old;
+		old.swap(t_slots);
+		t_slots.assign(old.size() * 2, nullptr);
+		size_t mask = t_slots.size() - 1;
+		for (_json_key* k : old) {
+			if (k == nullptr) continue;
+			size_t i = k->hash & mask;
+			while (t_slots[i] != nullptr) i = (i + 1) & mask;
+			t_slots[i] = k;
+		}
+	}
+public:
+	json_key_table(const size_t limit = 0) : t_count(0), t_limit(limit) {}
+	~json_key_table() { reset(); }
+	json_key_table(const json_key_table&) = delete;
+	json_key_table& operator=(const json_key_table&) = delete;
+
+	//登録済みのキーを取得または登録(上限に達した場合はnullptr、表が保持するためresetまで有効)
+	_json_key* find_or_add(const char* p, const size_t n, const uint32_t hash) {
+		if (t_slots.empty()) t_slots.assign(64, nullptr);
+		size_t mask = t_slots.size() - 1;
+		size_t i = hash & mask;
+		for (; t_slots[i] != nullptr; i = (i + 1) & mask) {
+			_json_key* k = t_slots[i];
+			if (k->hash == hash && k->len == n && memcmp(k->data, p, n) == 0) return k;
+		}
+		if (t_limit != 0 && t_count >= t_limit) return nullptr;
+		_json_key* k = _json_key_new(p, n, hash);
+		t_slots[i] = k;
+		if (++t_count * 2 > t_slots.size()) grow();
+		return k;
+	}
+	json_key intern(const char* p, const size_t n) {
+		uint32_t hash = _json_hash_key(p, n);
+		_json_key* k = find_or_add(p, n, hash);
+		if (k == nullptr) return json_key(_json_key_new(p, n, hash), false); //上限を超えた場合は共有しない
+		return json_key(k, true);
+	}
+	json_key intern(const string& str) { return intern(str.data(), str.size()); }
+	void reset() {
+		//表の参照を解放(ノードが使用中のキーはノードの破棄まで残る)
+		for (_json_key* k : t_slots) if (k != nullptr) _json_key_release(k);
+		t_slots.clear();
+		t_count = 0;
+	}
+	void set_limit(const size_t limit) { t_limit = limit; }
+	size_t limit() const { return t_limit; }
+	size_t size() const { return t_count; }
+	//全体で共有する表
+	static json_key_table& global() {
+		static json_key_table table;
+		return table;
+	}
+};
+
+//書き出し先
+class json_sink {
+public:
+	virtual ~json_sink() {}
+	virtual bool write(const char* p, const size_t n) = 0;
+};
+
+#ifdef _JSON_POSIX
+//ファイルディスクリプタ(ファイル・ソケット・パイプ)
+class json_fd_sink : public json_sink {
+	int s_fd;
+public:
+	json_fd_sink(const int fd) : s_fd(fd) {}
+	bool write(const char* p, const size_t n) {
+		size_t done = 0;
+		while (done < n) {
+			ssize_t r = ::write(s_fd, p + done, n - done);
+			if (r < 0) {
+				if (errno == EINTR) continue;
+				return false;
+			}
+			done += (size_t)r;
+		}
+		return true;
+	}
+};
+#endif
+
+class json_file_sink : public json_sink {
+	FILE* s_fp;
+public:
+	json_file_sink(FILE* fp) : s_fp(fp) {}
+	bool write(const char* p, const size_t n) { return fwrite(p, 1, n, s_fp) == n; }
+};
+
+class json_ostream_sink : public json_sink {
+	ostream& s_os;
+public:
+	json_ostream_sink(ostream& os) : s_os(os) {}
+	bool write(const char* p, const size_t n) { return (bool)s_os.write(p, (streamsize)n); }
+};
+
+//任意の関数(falseを返すと書き出しを中断)
+class json_callback_sink : public json_sink {
+	function<bool(const char*, size_t)> s_fn;
+public:
+	json_callback_sink(function<bool(const char*, size_t)> fn) : s_fn(move(fn)) {}
+	bool write(const char* p, const size_t n) { return s_fn(p, n); }
+};
+
+//コンテナの出力のキャッシュ(出力時のインデントごと)
+struct _json_print_cache {
+	string text;
+	int indent;
+	string indentstr;
+};
+
+//書き出し先へのバッファ付き出力(書き出し先が無い場合はバッファに全て蓄積)
+class json_writer {
+	json_sink* w_sink;
+	string w_buf;
+	size_t w_written; //書き出し先へ出力したバイト数
+	bool w_cache;     //コンテナの出力キャッシュを使用
+	size_t w_nocache; //キャッシュできないノードを出力した回数
+	string w_indent; //改行+インデントを事前に展開したもの
+	string w_indentstr;
+	bool w_fail;
+public:
+	static const size_t buffer_size = 64 * 1024;
+
+	json_writer(json_sink* sink = nullptr, const string& indentstr = "\t") : w_sink(sink), w_written(0), w_cache(false), w_nocache(0), w_indent("\n"), w_indentstr(indentstr), w_fail(false) {
+		if (w_sink != nullptr) w_buf.reserve(buffer_size * 2);
+	}
+	~json_writer() { flush(); }
+	json_writer(const json_writer&) = delete;
+	json_writer& operator=(const json_writer&) = delete;
+
+	string& buf() { return w_buf; }
+	void put(const char c) { w_buf += c; }
+	void append(const char* p, const size_t n) { w_buf.append(p, n); }
+	void append(const string& str) { w_buf += str; }
+	void newline(const int level) {
+		//改行とlevel段のインデント
+		size_t need = 1 + level * w_indentstr.size();
+		while (w_indent.size() < need) w_indent += w_indentstr;
+		w_buf.append(w_indent.data(), need);
+	}
+	void string_value(const char* p, const size_t n) {
+		//エスケープした文字列を出力(長い文字列は分割して出力)
+		w_buf += '\"';
+		size_t pos = 0;
+		while (pos < n) {
+			size_t len = n - pos;
+			if (w_sink != nullptr && len > buffer_size) len = buffer_size;
+			_json_escape_encode(p + pos, len, w_buf);
+			pos += len;
+			check();
+		}
+		w_buf += '\"';
+	}
+	void string_value(const string& str) { string_value(str.data(), str.size()); }
+	void check() { if (w_sink != nullptr && w_buf.size() >= buffer_size) flush(); }
+	bool flush() {
+		if (w_sink != nullptr && !w_buf.empty()) {
+			_JSON_STAT_TIMER(ns_write);
+			if (!w_fail && !w_sink->write(w_buf.data(), w_buf.size())) w_fail = true;
+			w_written += w_buf.size();
+			w_buf.clear();
 		}
+		return !w_fail;
+	}
+	void write_through(const string& str) {
+		//大きな出力済みバッファはコピーせずに書き出し先へ渡す
+		if (w_sink == nullptr) { w_buf += str; return; }
+		flush();
+		_JSON_STAT_TIMER(ns_write);
+		if (!w_fail && !str.empty() && !w_sink->write(str.data(), str.size())) w_fail = true;
+		w_written += str.size();
+	}
+	bool failed() const { return w_fail; }
+	size_t written() const { return w_written; }
+	//コンテナの出力キャッシュ(書き出し先が無い場合のみ)
+	void use_cache() { w_cache = w_sink == nullptr; }
+	void no_cache() { ++w_nocache; }
+	size_t nocache_count() const { return w_nocache; }
+	bool cache_hit(const _json_print_cache* c, const int indent) {
+		if (!w_cache || c == nullptr || c->indent != indent || c->indentstr != w_indentstr) return false;
+		w_buf += c->text;
+		return true;
+	}
+	void cache_store(_json_print_cache*& c, const size_t start, const size_t nocache, const int indent) {
+		//startからの出力をキャッシュ(キャッシュできないノードを含む場合は保存しない)
+		if (!w_cache || w_nocache != nocache) return;
+		if (c == nullptr) c = new _json_print_cache;
+		c->text.assign(w_buf, start, string::npos);
+		c->indent = indent;
+		c->indentstr = w_indentstr;
+	}
+	const string& indentstr() const { return w_indentstr; }
+	string take() { return move(w_buf); }
+};
+
+//16進数1桁を変換(失敗した場合は-1)
+inline long _json_hex1(const char c) {
+	static const signed char hex[256] = {
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+		-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	};
+	return hex[(unsigned char)c];
+}
+//\uXXXXの16進数4桁を変換(失敗した場合は-1)
+inline long _json_hex4(const char* p) {
+	long a = _json_hex1(p[0]), b = _json_hex1(p[1]), c = _json_hex1(p[2]), d = _json_hex1(p[3]);
+	if ((a | b | c | d) < 0) return -1;
+	return (a << 12) | (b << 8) | (c << 4) | d;
+}
+//コードポイントをutf-8で追加
+inline void _json_utf8_append(const unsigned long utf32, string& out) {
+	char buf[4];
+	if (utf32 <= 0x007F) { //1byte
+		out += (char)utf32;
+	} else if (utf32 <= 0x07FF) { //2byte
+		buf[0] = (char)(0xC0 | (utf32 >> 6));
+		buf[1] = (char)(0x80 | (utf32 & 0x3F));
+		out.append(buf, 2);
+	} else if (utf32 <= 0xFFFF) { //3byte
+		buf[0] = (char)(0xE0 | (utf32 >> 12));
+		buf[1] = (char)(0x80 | ((utf32 >> 6) & 0x3F));
+		buf[2] = (char)(0x80 | (utf32 & 0x3F));
+		out.append(buf, 3);
+	} else { //4byte
+		buf[0] = (char)(0xF0 | (utf32 >> 18));
+		buf[1] = (char)(0x80 | ((utf32 >> 12) & 0x3F));
+		buf[2] = (char)(0x80 | ((utf32 >> 6) & 0x3F));
+		buf[3] = (char)(0x80 | (utf32 & 0x3F));
+		out.append(buf, 4);
 	}
 }
 //JSON文字列から通常文字列へのエスケープ処理
-inline string _json_escape_decode(const string& json, size_t& pos, string& out) {
-	unsigned long utf32;
-	out = "";
-	while (pos < json.size()) {
-		if (json[pos] == '\"') { ++pos; return out; }
-		else if (json[pos] == '\\') {
-			//エスケープ処理
-			++pos;
-			if (pos >= json.size()) return out;
-			switch (json[pos]) {
-				case '\"': out += '\"'; ++pos; break;
-				case '\\': out += '\\'; ++pos; break;
-				case '/':  out += '/';  ++pos; break;
-				case 'b':  out += '\b'; ++pos; break;
-				case 'f':  out += '\f'; ++pos; break;
-				case 'n':  out += '\n'; ++pos; break;
-				case 'r':  out += '\r'; ++pos; break;
-				case 't':  out += '\t'; ++pos; break;
-				case 'u':
-					//utf-8に変換
-					++pos;
-					if (pos+4 >= json.size()) return out; //error
-					utf32 = stoul(json.substr(pos, 4), nullptr, 16); //unsinged long に変換
-					if (utf32 <= 0x007F) { //1byte
-						out += (char)utf32;
-					} else if (utf32 >= 0x0080 && utf32 <= 0x07FF) { //2byte
-						out += (char)(0xC0 | ((utf32 & 0x7C0) >> 6));
-						out += (char)(0x80 |  (utf32 & 0x3F));
-					} else if (utf32 >= 0x0800 && utf32 <= 0xFFFF) { //3byte
-						out += (char)(0xE0 | ((utf32 & 0xF000) >> 12));
-						out += (char)(0x80 | ((utf32 & 0xFC0) >> 6));
-						out += (char)(0x80 |  (utf32 & 0x3F));
-					} else if (utf32 >= 0x10000 && utf32 <= 0x1FFFFF) { //4byte
-						out += (char)(0xF0 | ((utf32 & 0x1C0000) >> 18));
-						out += (char)(0x80 | ((utf32 & 0x3F000) >> 12));
-						out += (char)(0x80 | ((utf32 & 0xFC0) >> 6));
-						out += (char)(0x80 |  (utf32 & 0x3F));
-					} else return out; //error 未定義
-					pos += 4;
-					break;
-				default: return out;
+//posは開始の"の次の位置、終了の"の次の位置まで進む(エラーの場合はエラー位置で止まりfalse)
+inline bool _json_unescape(const char* json, const size_t n, size_t& pos, string& out) {
+	long utf32, low;
+	out.clear();
+	while (pos < n) {
+		//エスケープ不要な範囲はまとめてコピー
+		size_t e = _json_scan_string(json, pos, n, false);
+		out.append(json + pos, e - pos);
+		pos = e;
+		if (pos >= n) return false;
+		if (json[pos] == '\"') { ++pos; return true; }
+		if (json[pos] != '\\') return false; //制御文字はエラー
+		//エスケープ処理
+		++pos;
+		if (pos >= n) return false;
+		_JSON_STAT(++_s->escapes);
+		switch (json[pos]) {
+			case '\"': out += '\"'; ++pos; break;
+			case '\\': out += '\\'; ++pos; break;
+			case '/':  out += '/';  ++pos; break;
+			case 'b':  out += '\b'; ++pos; break;
+			case 'f':  out += '\f'; ++pos; break;
+			case 'n':  out += '\n'; ++pos; break;
+			case 'r':  out += '\r'; ++pos; break;
+			case 't':  out += '\t'; ++pos; break;
+			case 'u':
+				//utf-8に変換
+				++pos;
+				if (pos+4 > n || (utf32 = _json_hex4(json + pos)) < 0) return false; //error
+				pos += 4;
+				if (utf32 >= 0xD800 && utf32 <= 0xDBFF && pos+6 <= n && json[pos] == '\\' && json[pos+1] == 'u') {
+					//サロゲートペア
+					low = _json_hex4(json + pos + 2);
+					if (low >= 0xDC00 && low <= 0xDFFF) {
+						utf32 = 0x10000 + ((utf32 - 0xD800) << 10) + (low - 0xDC00);
+						pos += 6;
+					}
+				}
+				_json_utf8_append((unsigned long)utf32, out);
+				break;
+			default: return false;
+		}
+	}
+	return false;
+}
+inline const string& _json_escape_decode(const char* json, const size_t n, size_t& pos, string& out) { _json_unescape(json, n, pos, out); return out; }
+inline const string& _json_escape_decode(const string& json, size_t& pos, string& out) { return _json_escape_decode(json.data(), json.size(), pos, out); }
+//JSON文字列を変換せずに検証して読み飛ばす(escapedはエスケープを含むか)
+inline bool _json_skip_string(const char* json, const size_t n, size_t& pos, bool& escaped) {
+	escaped = false;
+	while (pos < n) {
+		pos = _json_scan_string(json, pos, n, false);
+		if (pos >= n) return false;
+		if (json[pos] == '\"') { ++pos; return true; }
+		if (json[pos] != '\\' || pos+1 >= n) return false; //制御文字はエラー
+		escaped = true;
+		switch (json[pos+1]) {
+			case '\"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+				pos += 2;
+				break;
+			case 'u':
+				if (pos+6 > n || _json_hex4(json + pos + 2) < 0) return false;
+				pos += 6;
+				break;
+			default: return false;
+		}
+	}
+	return false;
+}
+
+//数値の文字列変換(doubleはGrisu2による最短の往復可能な表記)
+struct _json_diyfp {
+	uint64_t f;
+	int e;
+	_json_diyfp(const uint64_t f_, const int e_) : f(f_), e(e_) {}
+	_json_diyfp sub(const _json_diyfp& y) const { return _json_diyfp(f - y.f, e); }
+	_json_diyfp mul(const _json_diyfp& y) const {
+		uint64_t lo, hi = _json_mul128(f, y.f, lo);
+		return _json_diyfp(hi + (lo >> 63), e + y.e + 64); //四捨五入
+	}
+	_json_diyfp normalize() const {
+		int s = _json_clz64(f);
+		return _json_diyfp(f << s, e - s);
+	}
+};
+
+inline void _json_grisu2_round(char* buf, const int len, const uint64_t dist, const uint64_t delta, uint64_t rest, const uint64_t ten_k) {
+	//dist(=M+ - w)に最も近くなるように最後の桁を減らす
+	while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+		--buf[len - 1];
+		rest += ten_k;
+	}
+}
+
+inline int _json_grisu2(char* buf, int& decimal_exponent, const double value) {
+	//キャッシュ済みの10のべき乗(10^-300 ~ 10^324, 8刻み)
+	static const struct { uint64_t f; int e; int k; } cached_powers[] = {
+		{ 0xAB70FE17C79AC6CAULL, -1060, -300 },
+		{ 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+		{ 0xBE5691EF416BD60CULL, -1007, -284 },
+		{ 0x8DD01FAD907FFC3CULL,  -980, -276 },
+		{ 0xD3515C2831559A83ULL,  -954, -268 },
+		{ 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+		{ 0xEA9C227723EE8BCBULL,  -901, -252 },
+		{ 0xAECC49914078536DULL,  -874, -244 },
+		{ 0x823C12795DB6CE57ULL,  -847, -236 },
+		{ 0xC21094364DFB5637ULL,  -821, -228 },
+		{ 0x9096EA6F3848984FULL,  -794, -220 },
+		{ 0xD77485CB25823AC7ULL,  -768, -212 },
+		{ 0xA086CFCD97BF97F4ULL,  -741, -204 },
+		{ 0xEF340A98172AACE5ULL,  -715, -196 },
+		{ 0xB23867FB2A35B28EULL,  -688, -188 },
+		{ 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+		{ 0xC5DD44271AD3CDBAULL,  -635, -172 },
+		{ 0x936B9FCEBB25C996ULL,  -608, -164 },
+		{ 0xDBAC6C247D62A584ULL,  -582, -156 },
+		{ 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+		{ 0xF3E2F893DEC3F126ULL,  -529, -140 },
+		{ 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+		{ 0x87625F056C7C4A8BULL,  -475, -124 },
+		{ 0xC9BCFF6034C13053ULL,  -449, -116 },
+		{ 0x964E858C91BA2655ULL,  -422, -108 },
+		{ 0xDFF9772470297EBDULL,  -396, -100 },
+		{ 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+		{ 0xF8A95FCF88747D94ULL,  -343,  -84 },
+		{ 0xB94470938FA89BCFULL,  -316,  -76 },
+		{ 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+		{ 0xCDB02555653131B6ULL,  -263,  -60 },
+		{ 0x993FE2C6D07B7FACULL,  -236,  -52 },
+		{ 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+		{ 0xAA242499697392D3ULL,  -183,  -36 },
+		{ 0xFD87B5F28300CA0EULL,  -157,  -28 },
+		{ 0xBCE5086492111AEBULL,  -130,  -20 },
+		{ 0x8CBCCC096F5088CCULL,  -103,  -12 },
+		{ 0xD1B71758E219652CULL,   -77,   -4 },
+		{ 0x9C40000000000000ULL,   -50,    4 },
+		{ 0xE8D4A51000000000ULL,   -24,   12 },
+		{ 0xAD78EBC5AC620000ULL,     3,   20 },
+		{ 0x813F3978F8940984ULL,    30,   28 },
+		{ 0xC097CE7BC90715B3ULL,    56,   36 },
+		{ 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+		{ 0xD5D238A4ABE98068ULL,   109,   52 },
+		{ 0x9F4F2726179A2245ULL,   136,   60 },
+		{ 0xED63A231D4C4FB27ULL,   162,   68 },
+		{ 0xB0DE65388CC8ADA8ULL,   189,   76 },
+		{ 0x83C7088E1AAB65DBULL,   216,   84 },
+		{ 0xC45D1DF942711D9AULL,   242,   92 },
+		{ 0x924D692CA61BE758ULL,   269,  100 },
+		{ 0xDA01EE641A708DEAULL,   295,  108 },
+		{ 0xA26DA3999AEF774AULL,   322,  116 },
+		{ 0xF209787BB47D6B85ULL,   348,  124 },
+		{ 0xB454E4A179DD1877ULL,   375,  132 },
+		{ 0x865B86925B9BC5C2ULL,   402,  140 },
+		{ 0xC83553C5C8965D3DULL,   428,  148 },
+		{ 0x952AB45CFA97A0B3ULL,   455,  156 },
+		{ 0xDE469FBD99A05FE3ULL,   481,  164 },
+		{ 0xA59BC234DB398C25ULL,   508,  172 },
+		{ 0xF6C69A72A3989F5CULL,   534,  180 },
+		{ 0xB7DCBF5354E9BECEULL,   561,  188 },
+		{ 0x88FCF317F22241E2ULL,   588,  196 },
+		{ 0xCC20CE9BD35C78A5ULL,   614,  204 },
+		{ 0x98165AF37B2153DFULL,   641,  212 },
+		{ 0xE2A0B5DC971F303AULL,   667,  220 },
+		{ 0xA8D9D1535CE3B396ULL,   694,  228 },
+		{ 0xFB9B7CD9A4A7443CULL,   720,  236 },
+		{ 0xBB764C4CA7A44410ULL,   747,  244 },
+		{ 0x8BAB8EEFB6409C1AULL,   774,  252 },
+		{ 0xD01FEF10A657842CULL,   800,  260 },
+		{ 0x9B10A4E5E9913129ULL,   827,  268 },
+		{ 0xE7109BFBA19C0C9DULL,   853,  276 },
+		{ 0xAC2820D9623BF429ULL,   880,  284 },
+		{ 0x80444B5E7AA7CF85ULL,   907,  292 },
+		{ 0xBF21E44003ACDD2DULL,   933,  300 },
+		{ 0x8E679C2F5E44FF8FULL,   960,  308 },
+		{ 0xD433179D9C8CB841ULL,   986,  316 },
+		{ 0x9E19DB92B4E31BA9ULL,  1013,  324 },	};
+	static const uint32_t pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+	const int alpha = -60;
+
+	//境界値の計算
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const uint64_t F = bits & ((1ULL << 52) - 1);
+	const int E = (int)((bits >> 52) & 0x7FF);
+	const _json_diyfp v = E == 0 ? _json_diyfp(F, 1 - 1075) : _json_diyfp(F + (1ULL << 52), E - 1075);
+	const _json_diyfp w_plus = _json_diyfp(2 * v.f + 1, v.e - 1).normalize();
+	_json_diyfp m_minus = (F == 0 && E > 1) ? _json_diyfp(4 * v.f - 1, v.e - 2) : _json_diyfp(2 * v.f - 1, v.e - 1);
+	const _json_diyfp w_minus(m_minus.f << (m_minus.e - w_plus.e), w_plus.e);
+	const _json_diyfp w_v = v.normalize();
+
+	//w_plus.e + c.e + 64 が [alpha, gamma] に入る10のべき乗を選択
+	const int f = alpha - w_plus.e - 1;
+	const int k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+	const int index = (300 + k + 7) / 8;
+	const _json_diyfp c(cached_powers[index].f, cached_powers[index].e);
+	const _json_diyfp w = w_v.mul(c);
+	const _json_diyfp mm = w_minus.mul(c), mp = w_plus.mul(c);
+	const _json_diyfp M_minus(mm.f + 1, mm.e), M_plus(mp.f - 1, mp.e);
+	decimal_exponent = -cached_powers[index].k;
+
+	//桁の生成
+	uint64_t delta = M_plus.sub(M_minus).f;
+	uint64_t dist = M_plus.sub(w).f;
+	const int one_e = -M_plus.e;
+	const uint64_t one_f = 1ULL << one_e;
+	uint32_t p1 = (uint32_t)(M_plus.f >> one_e);
+	uint64_t p2 = M_plus.f & (one_f - 1);
+	int n = 10;
+	while (n > 1 && p1 < pow10[n - 1]) --n;
+	int len = 0;
+	while (n > 0) {
+		const uint32_t d = p1 / pow10[n - 1];
+		p1 %= pow10[n - 1];
+		buf[len++] = (char)('0' + d);
+		--n;
+		const uint64_t rest = ((uint64_t)p1 << one_e) + p2;
+		if (rest <= delta) {
+			decimal_exponent += n;
+			_json_grisu2_round(buf, len, dist, delta, rest, (uint64_t)pow10[n] << one_e);
+			return len;
+		}
+	}
+	int m = 0;
+	for (;;) {
+		p2 *= 10;
+		buf[len++] = (char)('0' + (p2 >> one_e));
+		p2 &= one_f - 1;
+		++m;
+		delta *= 10;
+		dist *= 10;
+		if (p2 <= delta) break;
+	}
+	decimal_exponent -= m;
+	_json_grisu2_round(buf, len, dist, delta, p2, one_f);
+	return len;
+}
+
+//整数の書き出し(bufの末尾から書き込み、先頭の位置を返す)
+inline char* _json_utoa_rev(uint64_t v, char* end) {
+	static const char digits[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+	while (v >= 100) {
+		const unsigned r = (unsigned)(v % 100) * 2;
+		v /= 100;
+		*--end = digits[r + 1];
+		*--end = digits[r];
+	}
+	if (v >= 10) {
+		*--end = digits[v * 2 + 1];
+		*--end = digits[v * 2];
+	} else *--end = (char)('0' + v);
+	return end;
+}
+inline char* _json_utoa(const uint64_t v, char* buf) {
+	char tmp[20];
+	char* p = _json_utoa_rev(v, tmp + 20);
+	size_t len = tmp + 20 - p;
+	memcpy(buf, p, len);
+	return buf + len;
+}
+inline char* _json_itoa(const int64_t v, char* buf) {
+	if (v < 0) { *buf++ = '-'; return _json_utoa(0 - (uint64_t)v, buf); }
+	return _json_utoa((uint64_t)v, buf);
+}
+
+//doubleの書き出し(bufは32byte以上、終端の位置を返す)
+//小数点以下がない値は"1.0"のように書き出し、10^-5未満と10^15以上は指数表記
+inline char* _json_dtoa(const double value, char* buf) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	if (((bits >> 52) & 0x7FF) == 0x7FF) { memcpy(buf, "null", 4); return buf + 4; } //NaN, InfinityはJSONで表現できない
+	if (bits >> 63) *buf++ = '-';
+	if ((bits << 1) == 0) { memcpy(buf, "0.0", 3); return buf + 3; }
+	int dexp;
+	const int k = _json_grisu2(buf, dexp, value < 0 ? -value : value);
+	const int n = k + dexp; //値 = 0.digits * 10^n
+	if (k <= n && n <= 15) {
+		//digits000.0
+		memset(buf + k, '0', n - k);
+		buf[n] = '.';
+		buf[n + 1] = '0';
+		return buf + n + 2;
+	}
+	if (0 < n && n <= 15) {
+		//dig.its
+		memmove(buf + n + 1, buf + n, k - n);
+		buf[n] = '.';
+		return buf + k + 1;
+	}
+	if (-5 < n && n <= 0) {
+		//0.000digits
+		memmove(buf + 2 - n, buf, k);
+		buf[0] = '0';
+		buf[1] = '.';
+		memset(buf + 2, '0', -n);
+		return buf + 2 - n + k;
+	}
+	//d.igitse+XX
+	if (k > 1) {
+		memmove(buf + 2, buf + 1, k - 1);
+		buf[1] = '.';
+		buf += k + 1;
+	} else buf += 1;
+	*buf++ = 'e';
+	*buf++ = n - 1 < 0 ? '-' : '+';
+	return _json_utoa((uint64_t)(n - 1 < 0 ? 1 - n : n - 1), buf);
+}
+
+//doubleを整数に変換(範囲外は上限・下限に丸め、NaNは0)
+inline int64_t _json_clamp_int(const double d) {
+	if (d != d) return 0;
+	if (d >= 9223372036854775808.0) return INT64_MAX;
+	if (d < -9223372036854775808.0) return INT64_MIN;
+	return (int64_t)d;
+}
+inline uint64_t _json_clamp_uint(const double d) {
+	if (!(d > 0)) return 0;
+	if (d >= 18446744073709551616.0) return UINT64_MAX;
+	return (uint64_t)d;
+}
+
+//数値の値(整数は精度を保って格納)
+struct _json_numval {
+	char kind; //'d'=double, 'i'=int64, 'u'=uint64
+	union {
+		double d;
+		int64_t i;
+		uint64_t u;
+	};
+	_json_numval() : kind('d'), d(0) {}
+	double to_double() const { return kind == 'd' ? d : kind == 'i' ? (double)i : (double)u; }
+	char* write(char* buf) const { return kind == 'd' ? _json_dtoa(d, buf) : kind == 'i' ? _json_itoa(i, buf) : _json_utoa(u, buf); }
+	string to_string() const { char buf[32]; return string(buf, write(buf)); }
+	//整数に変換(小数部は切り捨て、範囲外は上限・下限に丸める)
+	int64_t clamp_int() const { return kind == 'd' ? _json_clamp_int(d) : kind == 'i' ? i : (u > (uint64_t)INT64_MAX ? INT64_MAX : (int64_t)u); }
+	uint64_t clamp_uint() const { return kind == 'd' ? _json_clamp_uint(d) : kind == 'u' ? u : (i < 0 ? 0 : (uint64_t)i); }
+	//整数として正確に表せる場合のみ変換
+	bool to_int(int64_t& out) const {
+		if (kind == 'i') { out = i; return true; }
+		if (kind == 'u' || !(d >= -9223372036854775808.0 && d < 9223372036854775808.0) || d != (double)(int64_t)d) return false;
+		out = (int64_t)d;
+		return true;
+	}
+	bool to_uint(uint64_t& out) const {
+		if (kind == 'u') { out = u; return true; }
+		if (kind == 'i') { if (i < 0) return false; out = (uint64_t)i; return true; }
+		if (!(d >= 0 && d < 18446744073709551616.0) || d != (double)(uint64_t)d) return false;
+		out = (uint64_t)d;
+		return true;
+	}
+};
+
+//10進数 w * 10^q をdoubleに変換(Eisel-Lemire)、判定できない場合はfalse
+inline bool _json_eisel_lemire(uint64_t w, const int64_t q, const bool neg, double& out) {
+	//5^q の128bit近似値(q = -342 ~ 308)
+	static const uint64_t pow5[] = {
+		0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL,
+		0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL,
+		0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL,
+		0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL,
+		0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL,
+		0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL,
+		0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL,
+		0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL,
+		0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL,
+		0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL,
+		0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL,
+		0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL,
+		0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL,
+		0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL,
+		0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL,
+		0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL,
+		0x84A57695FE98746DULL, 0x014BB630F7604B57ULL,
+		0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL,
+		0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL,
+		0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL,
+		0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL,
+		0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL,
+		0xFD00B897478238D0ULL, 0x8920B098955522B4ULL,
+		0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL,
+		0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL,
+		0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL,
+		0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL,
+		0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL,
+		0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL,
+		0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL,
+		0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL,
+		0xEBA09271E88D976BULL, 0xF7864A44C633682EULL,
+		0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL,
+		0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL,
+		0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL,
+		0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL,
+		0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL,
+		0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL,
+		0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL,
+		0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL,
+		0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL,
+		0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL,
+		0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL,
+		0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL,
+		0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL,
+		0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL,
+		0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL,
+		0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL,
+		0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL,
+		0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL,
+		0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL,
+		0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL,
+		0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL,
+		0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL,
+		0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL,
+		0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL,
+		0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL,
+		0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL,
+		0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL,
+		0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL,
+		0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL,
+		0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL,
+		0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL,
+		0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL,
+		0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL,
+		0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL,
+		0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL,
+		0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL,
+		0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL,
+		0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL,
+		0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL,
+		0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL,
+		0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL,
+		0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL,
+		0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL,
+		0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL,
+		0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL,
+		0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL,
+		0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL,
+		0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL,
+		0xC987434744AC874EULL, 0xA327FFB266B56220ULL,
+		0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL,
+		0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL,
+		0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL,
+		0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL,
+		0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL,
+		0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL,
+		0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL,
+		0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL,
+		0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL,
+		0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL,
+		0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL,
+		0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL,
+		0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL,
+		0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL,
+		0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL,
+		0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL,
+		0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL,
+		0xAECC49914078536DULL, 0x58FAE9F773886E18ULL,
+		0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL,
+		0x888F99797A5E012DULL, 0x6D8406C952429603ULL,
+		0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL,
+		0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL,
+		0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL,
+		0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL,
+		0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL,
+		0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL,
+		0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL,
+		0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL,
+		0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL,
+		0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL,
+		0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL,
+		0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL,
+		0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL,
+		0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL,
+		0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL,
+		0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL,
+		0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL,
+		0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL,
+		0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL,
+		0xB913179899F68584ULL, 0x28E2557B59846E3FULL,
+		0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL,
+		0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL,
+		0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL,
+		0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL,
+		0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL,
+		0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL,
+		0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL,
+		0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL,
+		0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL,
+		0xD77485CB25823AC7ULL, 0x7D633293366B828BULL,
+		0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL,
+		0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL,
+		0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL,
+		0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL,
+		0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL,
+		0xCD795BE870516656ULL, 0x67902E276C921F8BULL,
+		0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL,
+		0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL,
+		0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL,
+		0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL,
+		0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL,
+		0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL,
+		0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL,
+		0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL,
+		0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL,
+		0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL,
+		0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL,
+		0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL,
+		0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL,
+		0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL,
+		0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL,
+		0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL,
+		0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL,
+		0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL,
+		0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL,
+		0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL,
+		0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL,
+		0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL,
+		0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL,
+		0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL,
+		0xD47487CC8470652BULL, 0x7647C3200069671FULL,
+		0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL,
+		0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL,
+		0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL,
+		0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL,
+		0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL,
+		0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL,
+		0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL,
+		0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL,
+		0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL,
+		0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL,
+		0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL,
+		0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL,
+		0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL,
+		0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL,
+		0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL,
+		0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL,
+		0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL,
+		0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL,
+		0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL,
+		0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL,
+		0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL,
+		0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL,
+		0x8C974F7383725573ULL, 0x1E414218C73A13FBULL,
+		0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL,
+		0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL,
+		0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL,
+		0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL,
+		0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL,
+		0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL,
+		0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL,
+		0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL,
+		0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL,
+		0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL,
+		0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL,
+		0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL,
+		0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL,
+		0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL,
+		0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL,
+		0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL,
+		0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL,
+		0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL,
+		0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL,
+		0xBE89523386091465ULL, 0xF6BBB397F1135823ULL,
+		0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL,
+		0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL,
+		0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL,
+		0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL,
+		0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL,
+		0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL,
+		0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL,
+		0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL,
+		0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL,
+		0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL,
+		0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL,
+		0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL,
+		0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL,
+		0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL,
+		0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL,
+		0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL,
+		0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL,
+		0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL,
+		0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL,
+		0x811CCC668829B887ULL, 0x0806357D5A3F525FULL,
+		0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL,
+		0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL,
+		0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL,
+		0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL,
+		0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL,
+		0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL,
+		0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL,
+		0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL,
+		0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL,
+		0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL,
+		0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL,
+		0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL,
+		0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL,
+		0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL,
+		0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL,
+		0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL,
+		0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL,
+		0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL,
+		0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL,
+		0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL,
+		0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL,
+		0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL,
+		0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL,
+		0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL,
+		0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL,
+		0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL,
+		0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL,
+		0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL,
+		0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL,
+		0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL,
+		0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL,
+		0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL,
+		0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL,
+		0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL,
+		0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL,
+		0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL,
+		0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL,
+		0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL,
+		0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL,
+		0xED246723473E3813ULL, 0x290123E9AAB23B68ULL,
+		0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL,
+		0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL,
+		0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL,
+		0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL,
+		0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL,
+		0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL,
+		0x8D590723948A535FULL, 0x579C487E5A38AD0EULL,
+		0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL,
+		0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL,
+		0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL,
+		0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL,
+		0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL,
+		0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL,
+		0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL,
+		0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL,
+		0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL,
+		0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL,
+		0xCDB02555653131B6ULL, 0x3792F412CB06794DULL,
+		0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL,
+		0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL,
+		0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL,
+		0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL,
+		0x9CED737BB6C4183DULL, 0x55464DD69685606BULL,
+		0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL,
+		0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL,
+		0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL,
+		0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL,
+		0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL,
+		0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL,
+		0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL,
+		0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL,
+		0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL,
+		0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL,
+		0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL,
+		0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL,
+		0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL,
+		0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL,
+		0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL,
+		0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL,
+		0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL,
+		0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL,
+		0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL,
+		0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL,
+		0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL,
+		0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL,
+		0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL,
+		0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL,
+		0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL,
+		0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL,
+		0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL,
+		0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL,
+		0xC612062576589DDAULL, 0x95364AFE032A819EULL,
+		0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL,
+		0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL,
+		0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL,
+		0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL,
+		0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL,
+		0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL,
+		0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL,
+		0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL,
+		0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL,
+		0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL,
+		0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL,
+		0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL,
+		0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL,
+		0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL,
+		0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL,
+		0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL,
+		0x89705F4136B4A597ULL, 0x31680A88F8953031ULL,
+		0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL,
+		0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL,
+		0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL,
+		0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL,
+		0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL,
+		0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL,
+		0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL,
+		0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL,
+		0x8000000000000000ULL, 0x0000000000000000ULL,
+		0xA000000000000000ULL, 0x0000000000000000ULL,
+		0xC800000000000000ULL, 0x0000000000000000ULL,
+		0xFA00000000000000ULL, 0x0000000000000000ULL,
+		0x9C40000000000000ULL, 0x0000000000000000ULL,
+		0xC350000000000000ULL, 0x0000000000000000ULL,
+		0xF424000000000000ULL, 0x0000000000000000ULL,
+		0x9896800000000000ULL, 0x0000000000000000ULL,
+		0xBEBC200000000000ULL, 0x0000000000000000ULL,
+		0xEE6B280000000000ULL, 0x0000000000000000ULL,
+		0x9502F90000000000ULL, 0x0000000000000000ULL,
+		0xBA43B74000000000ULL, 0x0000000000000000ULL,
+		0xE8D4A51000000000ULL, 0x0000000000000000ULL,
+		0x9184E72A00000000ULL, 0x0000000000000000ULL,
+		0xB5E620F480000000ULL, 0x0000000000000000ULL,
+		0xE35FA931A0000000ULL, 0x0000000000000000ULL,
+		0x8E1BC9BF04000000ULL, 0x0000000000000000ULL,
+		0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL,
+		0xDE0B6B3A76400000ULL, 0x0000000000000000ULL,
+		0x8AC7230489E80000ULL, 0x0000000000000000ULL,
+		0xAD78EBC5AC620000ULL, 0x0000000000000000ULL,
+		0xD8D726B7177A8000ULL, 0x0000000000000000ULL,
+		0x878678326EAC9000ULL, 0x0000000000000000ULL,
+		0xA968163F0A57B400ULL, 0x0000000000000000ULL,
+		0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL,
+		0x84595161401484A0ULL, 0x0000000000000000ULL,
+		0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL,
+		0xCECB8F27F4200F3AULL, 0x0000000000000000ULL,
+		0x813F3978F8940984ULL, 0x4000000000000000ULL,
+		0xA18F07D736B90BE5ULL, 0x5000000000000000ULL,
+		0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL,
+		0xFC6F7C4045812296ULL, 0x4D00000000000000ULL,
+		0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL,
+		0xC5371912364CE305ULL, 0x6C28000000000000ULL,
+		0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL,
+		0x9A130B963A6C115CULL, 0x3C7F400000000000ULL,
+		0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL,
+		0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL,
+		0x96769950B50D88F4ULL, 0x1314448000000000ULL,
+		0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL,
+		0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL,
+		0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL,
+		0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL,
+		0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL,
+		0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL,
+		0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL,
+		0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL,
+		0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL,
+		0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL,
+		0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL,
+		0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL,
+		0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL,
+		0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL,
+		0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL,
+		0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL,
+		0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL,
+		0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL,
+		0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL,
+		0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL,
+		0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL,
+		0x9F4F2726179A2245ULL, 0x01D762422C946590ULL,
+		0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL,
+		0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL,
+		0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL,
+		0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL,
+		0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL,
+		0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL,
+		0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL,
+		0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL,
+		0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL,
+		0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL,
+		0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL,
+		0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL,
+		0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL,
+		0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL,
+		0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL,
+		0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL,
+		0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL,
+		0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL,
+		0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL,
+		0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL,
+		0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL,
+		0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL,
+		0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL,
+		0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL,
+		0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL,
+		0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL,
+		0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL,
+		0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL,
+		0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL,
+		0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL,
+		0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL,
+		0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL,
+		0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL,
+		0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL,
+		0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL,
+		0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL,
+		0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL,
+		0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL,
+		0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL,
+		0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL,
+		0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL,
+		0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL,
+		0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL,
+		0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL,
+		0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL,
+		0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL,
+		0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL,
+		0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL,
+		0x884134FE908658B2ULL, 0x3109058D147FDCDDULL,
+		0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL,
+		0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL,
+		0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL,
+		0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL,
+		0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL,
+		0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL,
+		0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL,
+		0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL,
+		0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL,
+		0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL,
+		0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL,
+		0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL,
+		0x9AE757596946075FULL, 0x3375788DE9B06958ULL,
+		0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL,
+		0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL,
+		0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL,
+		0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL,
+		0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL,
+		0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL,
+		0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL,
+		0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL,
+		0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL,
+		0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL,
+		0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL,
+		0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL,
+		0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL,
+		0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL,
+		0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL,
+		0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL,
+		0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL,
+		0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL,
+		0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL,
+		0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL,
+		0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL,
+		0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL,
+		0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL,
+		0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL,
+		0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL,
+		0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL,
+		0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL,
+		0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL,
+		0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL,
+		0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL,
+		0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL,
+		0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL,
+		0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL,
+		0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL,
+		0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL,
+		0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL,
+		0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL,
+		0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL,
+		0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL,
+		0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL,
+		0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL,
+		0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL,
+		0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL,
+		0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL,
+		0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL,
+		0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL,
+		0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL,
+		0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL,
+		0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL,
+		0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL,
+		0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL,
+		0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL,
+		0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL,
+		0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL,
+		0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL,
+		0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL,
+		0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL,
+		0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL,
+		0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL,
+		0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL,
+		0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL,
+		0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL,
+		0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL,
+		0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL,
+		0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL,
+		0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL,
+		0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL,
+		0x8FA475791A569D10ULL, 0xF96E017D694487BCULL,
+		0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL,
+		0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL,
+		0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL,
+		0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL,
+		0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL,
+		0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL,
+		0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL,
+		0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL,
+		0x85C7056562757456ULL, 0xF6872D5667844E49ULL,
+		0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL,
+		0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL,
+		0x82A45B450226B39CULL, 0xECC0024661173473ULL,
+		0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL,
+		0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL,
+		0xFF290242C83396CEULL, 0x7E67047175A15271ULL,
+		0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL,
+		0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL,
+		0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL,
+		0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL,
+		0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL,
+		0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL,
+		0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL,
+		0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL,
+		0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL,
+		0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL,
+		0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL,
+		0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL,
+		0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL,
+		0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL,
+		0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL,
+		0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL,
+		0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL,
+		0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL,
+		0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL,
+		0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL,
+		0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL,
+		0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL,
+		0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL,
+		0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL,
+		0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL,
+		0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL,
+		0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL,
+		0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL,
+		0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL,
+		0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL,
+		0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL,
+		0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL,
+		0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL,
+		0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL,
+		0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL,
+		0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL,
+		0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL,
+		0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL,
+		0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL,
+		0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL,
+		0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL,
+		0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL,
+		0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL,
+		0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL,
+		0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL,
+		0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL,
+		0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL,
+		0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL,
+		0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL,
+		0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL,
+		0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL,
+		0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL,
+		0x8533285C936B35DEULL, 0xD53A88958F87275FULL,
+		0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL,
+		0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL,
+		0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL,
+		0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL,
+		0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL,
+		0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL,
+		0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL,
+		0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL,
+		0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL,
+		0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL,
+		0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL,
+		0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL,
+		0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL,
+		0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL,
+		0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL,
+		0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL,
+		0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL,
+		0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL,
+		0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL,
+		0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL,
+		0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL,
+		0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL,
+		0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL,
+		0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL,
+		0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL,
+		0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL,
+		0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL,
+		0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL,
+		0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL,
+		0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL,
+		0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL,
+		0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL,
+		0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL,
+		0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL,
+		0xA0555E361951C366ULL, 0xD7E105BCC332621FULL,
+		0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL,
+		0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL,
+		0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL,
+		0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL,
+		0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL,
+		0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL,
+		0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL,
+		0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL,
+		0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL,
+		0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL,
+		0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL,
+		0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL,
+		0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL,
+		0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL,
+		0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL,	};
+	uint64_t bits;
+	if (w == 0 || q < -342) bits = 0;
+	else if (q > 308) bits = 0x7FFULL << 52;
+	else {
+		const int lz = _json_clz64(w);
+		w <<= lz;
+		const size_t index = 2 * (size_t)(q + 342);
+		uint64_t lo, hi = _json_mul128(w, pow5[index], lo);
+		if ((hi & 0x1FF) == 0x1FF) {
+			//下位の積で補正
+			uint64_t lo2, hi2 = _json_mul128(w, pow5[index + 1], lo2);
+			lo += hi2;
+			if (hi2 > lo) ++hi;
+		}
+		if (lo == 0xFFFFFFFFFFFFFFFFULL && (q < -27 || q > 55)) return false;
+		const int upperbit = (int)(hi >> 63);
+		uint64_t mantissa = hi >> (upperbit + 9);
+		int64_t power2 = ((((152170 + 65536) * q) >> 16) + 63) + upperbit - lz + 1023;
+		if (power2 <= 0) {
+			//非正規化数
+			if (-power2 + 1 >= 64) bits = 0;
+			else {
+				mantissa >>= -power2 + 1;
+				mantissa += (mantissa & 1);
+				mantissa >>= 1;
+				bits = mantissa; //最上位bitが立った場合は指数部の1になる
 			}
-		} else if (json[pos] >= ' ' || json[pos] < '\a') { out += json[pos]; ++pos; }
-		else return out;
+		} else {
+			//偶数丸め
+			if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << (upperbit + 9)) == hi) mantissa &= ~1ULL;
+			mantissa += (mantissa & 1);
+			mantissa >>= 1;
+			if (mantissa >= (2ULL << 52)) { mantissa = 1ULL << 52; ++power2; }
+			mantissa &= ~(1ULL << 52);
+			bits = power2 >= 0x7FF ? 0x7FFULL << 52 : (mantissa | ((uint64_t)power2 << 52));
+		}
 	}
-	return out;
+	if (neg) bits |= 1ULL << 63;
+	memcpy(&out, &bits, sizeof(out));
+	return true;
+}
+
+//数値の読み込み(文字列の一時領域を使用しない)
+//posは数値の次の文字の位置まで進む
+inline bool _json_parse_number(const char* p, const size_t n, size_t& pos, _json_numval& out) {
+	static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	size_t i = pos;
+	const bool neg = i < n && p[i] == '-';
+	if (neg) ++i;
+	if (i >= n || (unsigned)(p[i] - '0') > 9) return false;
+	uint64_t mant = 0;
+	int digits = 0; //有効桁数(19桁まで)
+	int64_t exp10 = 0;
+	bool trunc = false, integer = true;
+	//整数部(先頭の0の後に数字は続かない)
+	if (p[i] == '0') {
+		++i;
+		if (i < n && (unsigned)(p[i] - '0') <= 9) return false;
+	} else {
+		for (; i < n && (unsigned)(p[i] - '0') <= 9; ++i) {
+			if (digits < 19) { mant = mant * 10 + (p[i] - '0'); ++digits; }
+			else { ++exp10; if (p[i] != '0') trunc = true; }
+		}
+	}
+	//小数部
+	if (i < n && p[i] == '.') {
+		integer = false;
+		++i;
+		if (i >= n || (unsigned)(p[i] - '0') > 9) return false;
+		for (; i < n && (unsigned)(p[i] - '0') <= 9; ++i) {
+			if (digits < 19) { mant = mant * 10 + (p[i] - '0'); --exp10; if (mant != 0) ++digits; }
+			else if (p[i] != '0') trunc = true;
+		}
+	}
+	//指数部
+	if (i < n && (p[i] == 'e' || p[i] == 'E')) {
+		integer = false;
+		++i;
+		bool eneg = false;
+		if (i < n && (p[i] == '+' || p[i] == '-')) { eneg = p[i] == '-'; ++i; }
+		if (i >= n || (unsigned)(p[i] - '0') > 9) return false;
+		int64_t e = 0;
+		for (; i < n && (unsigned)(p[i] - '0') <= 9; ++i) if (e < 100000) e = e * 10 + (p[i] - '0');
+		exp10 += eneg ? -e : e;
+	}
+	const size_t start = pos;
+	pos = i;
+	if (integer) {
+		//整数は int64 / uint64 で格納
+		//20桁の場合はuint64の範囲内か判定
+		if (exp10 == 0 || (exp10 == 1 && (mant < 1844674407370955161ULL || (mant == 1844674407370955161ULL && p[i-1] <= '5')))) {
+			const uint64_t u = exp10 == 1 ? mant * 10 + (p[i-1] - '0') : mant;
+			if (!neg) {
+				if (u <= (uint64_t)INT64_MAX) { out.kind = 'i'; out.i = (int64_t)u; }
+				else { out.kind = 'u'; out.u = u; }
+				return true;
+			}
+			if (u != 0 && u <= (uint64_t)INT64_MAX + 1) { out.kind = 'i'; out.i = (int64_t)(0 - u); return true; }
+		}
+	}
+	out.kind = 'd';
+	if (!trunc) {
+		//Clingerの高速パス(仮数と10のべき乗がdoubleで正確に表現できる場合)
+		if (mant <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+			double d = (double)mant;
+			d = exp10 < 0 ? d / pow10[-exp10] : d * pow10[exp10];
+			out.d = neg ? -d : d;
+			return true;
+		}
+		if (_json_eisel_lemire(mant, exp10, neg, out.d)) return true;
+	}
+	//19桁を超える仮数など、判定できない場合はstrtodで変換
+	char buf[128];
+	const size_t len = i - start;
+	if (len < sizeof(buf)) {
+		memcpy(buf, p + start, len);
+		buf[len] = '\0';
+		out.d = strtod(buf, nullptr);
+	} else out.d = strtod(string(p + start, len).c_str(), nullptr);
+	return true;
 }
+inline bool _json_parse_number(const string& json, size_t& pos, _json_numval& out) { return _json_parse_number(json.data(), json.size(), pos, out); }
+
+template <typename T> class json_node;
+template <typename T> void _json_print_parallel(json_node<T>* n, json_writer& w, const int indent, const unsigned threads);
+template <class N, class... A> N* _json_new(_json_arena* a, A&&... args);
 
 template <typename T = char>
 class json_node {
 protected:
 	json_node<T>* n_parent;
 	json_node<T>** n_parent_pos;
+	_json_arena* n_arena;
 
 	void set_parent(json_node<T>* n, json_node<T>* p, json_node<T>** pos) {
-		if (n->n_parent != nullptr) *n->n_parent_pos = nullptr; //親ノードとの連結を解除
+		if (n->n_parent != nullptr) { *n->n_parent_pos = nullptr; n->n_parent->changed(); } //親ノードとの連結を解除
 		n->n_parent = p;
 		n->n_parent_pos = pos;
+		p->changed();
 	}
+	//変更されたノードから親ノードへ向かって出力のキャッシュを破棄
+	//キャッシュを持つコンテナの子孫はすべてキャッシュを持つため、キャッシュの無いコンテナで終了する
+	void changed() { for (json_node<T>* n = this; n != nullptr && n->_drop_cache(); n = n->n_parent); }
 	void reset_parent() { n_parent = nullptr; n_parent_pos = nullptr; }
+	json_node<T>** new_slot() {
+		//子ノード用のスロットを確保(アリーナ上のノードはアリーナから確保)
+		json_node<T>** s = n_arena != nullptr ? (json_node<T>**)n_arena->allocate(sizeof(json_node<T>*), alignof(json_node<T>*)) : new json_node<T>*;
+		if (n_arena == nullptr) _JSON_STAT_ALLOC(sizeof(json_node<T>*));
+		*s = nullptr;
+		return s;
+	}
+	void delete_slot(json_node<T>** s) { if (n_arena == nullptr) delete s; }
 public:
-	json_node() {}
-	virtual ~json_node() {}
+	json_node() : n_arena(nullptr) {}
+	virtual ~json_node() { if (n_parent != nullptr) n_parent->changed(); }
+
+	//アリーナ上のノードはdeleteしてもメモリを解放しない(アリーナの破棄時に一括解放)
+	//ヒープのノードは::operator new/deleteで確保・解放
+	//ヘッダの分ずらしたポインタをGCCが対応しない確保元と誤認するため、確保・解放はインライン展開しない
+	_JSON_NOINLINE static void* operator new(size_t size) {
+		_json_node_header* h = (_json_node_header*)::operator new(sizeof(_json_node_header) + size);
+		_JSON_STAT_ALLOC(sizeof(_json_node_header) + size);
+		h->arena = nullptr;
+		return h + 1;
+	}
+	_JSON_NOINLINE static void operator delete(void* p) {
+		if (p == nullptr) return;
+		_json_node_header* h = (_json_node_header*)p - 1;
+		if (h->arena == nullptr) ::operator delete(h);
+	}
+	_json_arena* arena() { return n_arena; }
+	template <class N, class... A> friend N* _json_new(_json_arena* a, A&&... args);
+
 	virtual json_type type() { return None; }
 	json_node<T>* parent() { return n_parent; }
-	virtual void _print(string& out, const string& indentstr, const int indent) { return; }
-	virtual string print(const int indent = 1, const string& indentstr = "\t") { return ""; }
+	virtual void _print(json_writer& w, const int indent) { return; }
+	//出力のキャッシュを破棄(親ノードへ続けて破棄する場合はtrue)
+	virtual bool _drop_cache() { return true; }
+	//このノード以下を複製(複製はヒープに確保し、親ノードとは連結しない)
+	virtual json_node<T>* clone() { return nullptr; }
+	string print(const int indent = 1, const string& indentstr = "\t") {
+		_JSON_STAT_SCOPE("print");
+		json_writer w(nullptr, indentstr);
+		_JSON_STAT_ENTER(type());
+		_print(w, indent);
+		_JSON_STAT_BYTES(w.buf().size());
+		return w.take();
+	}
+	//コンテナごとに出力をキャッシュして書き出し(変更の無いコンテナはキャッシュをそのまま出力)
+	string print_cached(const int indent = 1, const string& indentstr = "\t") {
+		json_writer w(nullptr, indentstr);
+		w.use_cache();
+		_print(w, indent);
+		return w.take();
+	}
+	//このノード以下と親ノードの出力のキャッシュを解放
+	void clear_print_cache() {
+		changed();
+		for (size_t i = 0, s = size(); i < s; ++i)
+			if (json_node<T>* c = _child(i)) c->clear_print_cache();
+	}
+	bool print_to(json_sink& sink, const int indent = 1, const string& indentstr = "\t") {
+		_JSON_STAT_SCOPE("print");
+		//バッファ単位で書き出し先へ出力
+		json_writer w(&sink, indentstr);
+		_JSON_STAT_ENTER(type());
+		_print(w, indent);
+		bool ok = w.flush();
+		_JSON_STAT_BYTES(w.written());
+		return ok;
+	}
+	//要素の多いコンテナを複数スレッドで出力(出力はprintと同じ)
+	string print_parallel(const int indent = 1, const string& indentstr = "\t", const unsigned threads = 0) {
+		json_writer w(nullptr, indentstr);
+		_json_print_parallel(this, w, indent, threads);
+		return w.take();
+	}
+	bool print_to_parallel(json_sink& sink, const int indent = 1, const string& indentstr = "\t", const unsigned threads = 0) {
+		json_writer w(&sink, indentstr);
+		_json_print_parallel(this, w, indent, threads);
+		return w.flush();
+	}
+	//コンテナの要素を順に参照(空の場合はnullptr)
+	virtual json_node<T>* _child(const size_t num) { return nullptr; }
+	virtual const _json_key* _child_key(const size_t num) { return nullptr; }
 	virtual json_node<T>* get_object(const string& key) { return nullptr; }
+	virtual json_node<T>* get_object(const json_key& key) { return nullptr; }
+	virtual json_node<T>* get_object(const char* key, const size_t len) { return get_object(string(key, len)); }
+	//文字列リテラルのキーは一時的なstringを作成せずに検索
+	template <size_t N> json_node<T>* get_object(const char (&key)[N]) { return get_object(key, strlen(key)); }
 	virtual json_node<T>* get_array(const size_t num) { return nullptr; }
 	virtual string get_string() { return ""; }
+	//型が一致する場合のみ取得(一致しない場合はfalse、値をコピー・変換しない)
+	//文字列の参照はノードを変更・削除するまで有効
+	virtual bool try_get_string(json_string_view& out) { return false; }
+	virtual bool try_get_number(double& out) { return false; }
+	virtual bool try_get_int(int64_t& out) { return false; } //整数として正確に表せる場合のみ
+	virtual bool try_get_uint(uint64_t& out) { return false; }
+	virtual bool try_get_bool(bool& out) { return false; }
+	json_string_view get_string_view() { json_string_view v; try_get_string(v); return v; }
 	virtual double get_number() { return 0; }
+	virtual int64_t get_int() { return _json_clamp_int(get_number()); }
+	virtual uint64_t get_uint() { return _json_clamp_uint(get_number()); }
 	virtual bool get_bool() { return false; }
+	virtual _json_numval get_numval() { _json_numval v; v.kind = 'd'; v.d = get_number(); return v; }
 	virtual json_node<T>* set_object(const string& key, json_node<T>* n) { return nullptr; }
+	virtual json_node<T>* set_object(const char* key, const size_t len, json_node<T>* n) { return set_object(string(key, len), n); }
+	template <size_t N> json_node<T>* set_object(const char (&key)[N], json_node<T>* n) { return set_object(key, strlen(key), n); }
+	json_node<T>* set_object(const json_key& key, json_node<T>* n) { return key.empty() ? nullptr : _set_key(key.get(), n); }
+	virtual json_node<T>* _set_key(_json_key* key, json_node<T>* n) { return nullptr; }
 	virtual json_node<T>* set_array(const size_t num, json_node<T>* n) { return nullptr; }
 	virtual json_node<T>* add_array(json_node<T>* n) { return nullptr; }
 	virtual void set_string(const string& str) {}
+	virtual void set_string(string&& str) { set_string((const string&)str); }
 	virtual void set_number(const double num) {}
+	virtual void set_int(const int64_t num) { set_number((double)num); }
+	virtual void set_uint(const uint64_t num) { set_number((double)num); }
 	virtual void set_bool(const bool b) {}
 	virtual void delete_object(const string& key) {}
 	virtual void delete_array(const size_t num, const int eraseflag = 0) {}
 	virtual void delete_all() {}
 	virtual void delete_empty() {}
 	virtual void resize(const size_t s) {}
+	//要素数の予約(コンテナ以外は何もしない)
+	virtual void reserve(const size_t s) {}
 	virtual size_t size() { return 0; }
 
-	virtual json_node<T>& operator[](const string& str) { return *this; }
-	virtual json_node<T>& operator[](const size_t num) { return *this; }
+	//ノードを作成して追加(コンテナと同じアリーナから確保、追加できない場合はnullptr)
+	template <class N, class K, class... A> N* emplace_object(const K& key, A&&... args) {
+		if (type() != Object) return nullptr;
+		N* n = _json_new<N>(n_arena, std::forward<A>(args)...);
+		if (set_object(key, n) == nullptr) { delete n; return nullptr; }
+		return n;
+	}
+	template <class N, class... A> N* emplace_array(A&&... args) {
+		if (type() != Array) return nullptr;
+		N* n = _json_new<N>(n_arena, std::forward<A>(args)...);
+		if (add_array(n) == nullptr) { delete n; return nullptr; }
+		return n;
+	}
+
+	//存在しない要素の参照先(共有されたnull、変更・追加・削除しないこと)
+	//アリーナ上に作成するため、誤ってdeleteしてもメモリは解放されない
+	static json_node<T>& null_node() {
+		static _json_arena a(256);
+		static json_node<T>* n = _json_new<json_null<T>>(&a);
+		return *n;
+	}
+	//要素の参照(存在しない場合はnull_node、存在の判定はget_object・get_arrayのnullptrで行う)
+	virtual json_node<T>& operator[](const string& str) { return null_node(); }
+	virtual json_node<T>& operator[](const json_key& key) { return null_node(); }
+	virtual json_node<T>& operator[](const size_t num) { return null_node(); }
+	template <size_t N> json_node<T>& operator[](const char (&key)[N]) { json_node<T>* n = get_object(key, strlen(key)); return n != nullptr ? *n : null_node(); }
 };
 
+//コンテナの要素を1つ出力(区切りは2つ目以降の要素の前に出力)
+template <typename T>
+inline void _json_print_member(json_writer& w, const int indent, const _json_key* key, json_node<T>* n, bool& first) {
+	if (!first) w.put(',');
+	first = false;
+	if (indent > 0) w.newline(indent);
+	if (key != nullptr) {
+		w.string_value(key->data, key->len);
+		if (indent > 0) w.append(" : ", 3);
+		else w.put(':');
+	}
+	_JSON_STAT_ENTER(n->type());
+	n->_print(w, indent > 0 ? indent+1 : 0);
+	_JSON_STAT_LEAVE(n->type());
+	w.check();
+}
+
 template <typename T = char>
 class json_object : public json_node<T> {
 	using json_node<T>::n_parent;
 	using json_node<T>::n_parent_pos;
 	using json_node<T>::set_parent;
 	using json_node<T>::reset_parent;
+	using json_node<T>::new_slot;
+	using json_node<T>::delete_slot;
 
-
-	map<string, json_node<T>**> nodelist;
+	//挿入順の配列(小さいオブジェクトは線形探索、大きいものはハッシュ索引を併用)
+	//索引を使用している間の削除はkeyとslotをnullptrにした削除済みの要素として残し、半数を超えたら詰める
+	struct _entry {
+		_json_key* key;
+		uint32_t hash;
+		json_node<T>** slot;
+	};
+	static const size_t linear_max = 8;
+	vector<_entry> nodelist;
+	vector<uint32_t> o_index; //オープンアドレス法(要素番号+1、0は空き)
+	size_t o_dead; //削除済みの要素数
+	_json_print_cache* o_cache; //出力のキャッシュ(print_cached)
 	friend class json_array<T>;
 
-	json_node<T>** find(const string& key) {
-		//ノードを検索
-		if (!nodelist.empty()) { //リストが存在
-			auto it = nodelist.find(key); //検索
-			if (it != nodelist.end()) return it->second; //mapに存在
+	void index_insert(const size_t num) {
+		size_t mask = o_index.size() - 1;
+		size_t i = nodelist[num].hash & mask;
+		while (o_index[i] != 0) i = (i + 1) & mask;
+		o_index[i] = (uint32_t)(num + 1);
+	}
+	void index_rebuild(const size_t hint = 0) {
+		//要素数(予約数)の2倍以上の2の累乗で作り直す
+		size_t cap = 32;
+		while (cap < max(nodelist.size(), hint) * 2) cap <<= 1;
+		o_index.assign(cap, 0);
+		for (size_t i = 0; i < nodelist.size(); ++i) index_insert(i);
+	}
+	static bool match(const _entry& e, const _json_key* k, const char* key, const size_t len, const uint32_t h) {
+		//共有されたキーはポインタで一致、それ以外はキャッシュしたハッシュ値で比較してから文字列を比較
+		return e.key != nullptr && (e.key == k || (e.hash == h && e.key->len == len && memcmp(e.key->data, key, len) == 0));
+	}
+	size_t find(const _json_key* k, const char* key, const size_t len, const uint32_t h) {
+		//ノードを検索(存在しない場合はnpos)
+		if (nodelist.size() <= linear_max) {
+			for (size_t i = 0; i < nodelist.size(); ++i)
+				if (match(nodelist[i], k, key, len, h)) return i;
+			return string::npos;
+		}
+		if (o_index.empty()) index_rebuild(); //delete_empty後は次の検索時に作り直す
+		size_t mask = o_index.size() - 1;
+		for (size_t i = h & mask; o_index[i] != 0; i = (i + 1) & mask)
+			if (match(nodelist[o_index[i] - 1], k, key, len, h)) return o_index[i] - 1;
+		return string::npos;
+	}
+	size_t find(const string& key) { return find(nullptr, key.data(), key.size(), _json_hash_key(key.data(), key.size())); }
+	size_t find(const _json_key* k) { return find(k, k->data, k->len, k->hash); }
+	size_t add_entry(_json_key* k) {
+		//キーを末尾に追加(キーの参照は呼び出し側で確保)
+		size_t num = nodelist.size();
+		nodelist.push_back(_entry{k, k->hash, new_slot()});
+		if (nodelist.size() > linear_max || !o_index.empty()) { //予約済みの索引は要素が少なくても更新
+			if (o_index.empty() || nodelist.size() * 2 > o_index.size()) index_rebuild();
+			else index_insert(num);
 		}
+		return num;
+	}
+	json_node<T>* assign(const size_t num, json_node<T>* n) {
+		json_node<T>** slot = nodelist[num].slot;
+		set_parent(n, this, slot);
+		*slot = n;
+		return n;
+	}
+	json_node<T>* get(const size_t num) {
+		if (num == string::npos) return nullptr;
+		if (*nodelist[num].slot != nullptr) return *nodelist[num].slot; //中身が存在
+		erase(num); //中身が存在しないので削除
 		return nullptr;
 	}
+	size_t drop_empty(const size_t num) {
+		//中身が削除された要素は取り除く(追加し直す場合は末尾になる)
+		if (num == string::npos || *nodelist[num].slot != nullptr) return num;
+		erase(num);
+		return string::npos;
+	}
+	json_node<T>& found(json_node<T>* n) { return n != nullptr ? *n : this->null_node(); }
+	void erase(const size_t num) {
+		//挿入順を保ったまま削除(索引を使用している場合は削除済みとして残す)
+		_json_key_release(nodelist[num].key);
+		delete_slot(nodelist[num].slot);
+		if (o_index.empty()) { nodelist.erase(nodelist.begin() + num); return; }
+		nodelist[num].key = nullptr;
+		nodelist[num].slot = nullptr;
+		if (++o_dead * 2 > nodelist.size()) compact();
+	}
+	void compact() {
+		//削除済みの要素を詰めて索引を作り直す
+		if (o_dead == 0) return;
+		nodelist.erase(remove_if(nodelist.begin(), nodelist.end(), [](const _entry& e) { return e.slot == nullptr; }), nodelist.end());
+		o_dead = 0;
+		if (!o_index.empty()) index_rebuild();
+	}
 public:
-	json_object() { reset_parent(); }
+	json_object() : o_dead(0), o_cache(nullptr) { reset_parent(); }
 	~json_object() {
 		delete_all();
+		delete o_cache;
 		if (n_parent != nullptr) *n_parent_pos = nullptr; //親ノードとの連結を解除
 	}
-	void _print(string& out, const string& indentstr, const int indent) {
-		//JSONテキスト出力
-		out += "{";
-		if (indent > 0) {
-			out += "\n";
-			for (auto it : nodelist) {
-				if (*it.second != nullptr) {
-					for (int i = 0; i < indent; ++i) out += indentstr;
-					out += "\"";
-					_json_escape_encode(it.first, out);
-					out += "\" : ";
-					(*it.second)->_print(out, indentstr, indent+1);
-					out += ",\n";
-				}
-			}
-			out.erase(out.end() - 2); //","を削除
-			for (int i = 0; i < indent-1; ++i) out += indentstr;
-		} else {
-			for (auto it : nodelist) {
-				if (*it.second != nullptr) {
-					out += "\"";
-					_json_escape_encode(it.first, out);
-					out += "\":";
-					(*it.second)->_print(out, indentstr, 0);
-					out += ",";
-				}
-			}
-			out.pop_back(); //","を削除
-		}
-		out += "}";
-		return;
+	void _print(json_writer& w, const int indent) {
+		//JSONテキスト出力(挿入順)
+		if (w.cache_hit(o_cache, indent)) return;
+		const size_t start = w.buf().size(), nocache = w.nocache_count();
+		w.put('{');
+		bool first = true;
+		for (auto& e : nodelist)
+			if (e.slot != nullptr && *e.slot != nullptr) _json_print_member(w, indent, e.key, *e.slot, first);
+		if (indent > 0 && !first) w.newline(indent-1);
+		w.put('}');
+		w.cache_store(o_cache, start, nocache, indent);
 	}
-	string print(const int indent = 1, const string& indentstr = "\t") {
-		string out;
-		_print(out, indentstr, indent);
-		return out;
+	bool _drop_cache() {
+		if (o_cache == nullptr) return false;
+		delete o_cache;
+		o_cache = nullptr;
+		return true;
 	}
-	json_type type() { return Object; }
-	json_node<T>* get_object(const string& key) {
-		//指定されたノードを取得
-		json_node<T>** f_node = find(key);
-		if (f_node != nullptr) { //mapに存在
-			if (*f_node != nullptr) return *f_node; //中身が存在
-			else {
-				//中身が存在しないのでmapから削除
-				delete f_node;
-				nodelist.erase(key);
-			}
+	json_node<T>* clone() {
+		//キーは参照を共有(アリーナ上のキーは複製)
+		json_object<T>* o = new json_object<T>;
+		o->reserve(nodelist.size() - o_dead);
+		for (auto& e : nodelist) {
+			json_node<T>* c = e.slot != nullptr && *e.slot != nullptr ? (*e.slot)->clone() : nullptr;
+			if (c == nullptr) continue;
+			if (e.key->arena) o->set_object(string(e.key->data, e.key->len), c);
+			else o->_set_key(e.key, c);
 		}
-		return nullptr;
+		return o;
 	}
-	json_node<T>* set_object(const string& key, json_node<T>* n) {
+	//番号による参照は削除済みの要素を詰めてから行う
+	json_node<T>* _child(const size_t num) { compact(); return num < nodelist.size() ? *nodelist[num].slot : nullptr; }
+	const _json_key* _child_key(const size_t num) { compact(); return num < nodelist.size() ? nodelist[num].key : nullptr; }
+	json_type type() { return Object; }
+	using json_node<T>::get_object;
+	json_node<T>* get_object(const string& key) { return get(find(key)); } //指定されたノードを取得
+	json_node<T>* get_object(const json_key& key) { return key.empty() ? nullptr : get(find(key.get())); }
+	json_node<T>* get_object(const char* key, const size_t len) { return get(find(nullptr, key, len, _json_hash_key(key, len))); }
+	using json_node<T>::set_object;
+	json_node<T>* set_object(const string& key, json_node<T>* n) { return set_object(key.data(), key.size(), n); }
+	json_node<T>* set_object(const char* key, const size_t len, json_node<T>* n) {
 		//指定されたノードを追加または変更(既存のノードを代入)
-		json_node<T>** f_node = find(key); //ノードを検索
-		if (f_node != nullptr) { //mapに存在
-			if (*f_node != nullptr) delete *f_node; //中身が存在する場合は削除する
-		} else nodelist[key] = new json_node<T>*; //リスト作成
-		set_parent(n, this, nodelist[key]);
-		*nodelist[key] = n;
-		return n;
+		uint32_t h = _json_hash_key(key, len);
+		size_t num = drop_empty(find(nullptr, key, len, h)); //ノードを検索
+		if (num != string::npos) delete *nodelist[num].slot; //存在
+		else num = add_entry(_json_key_new(key, len, h, this->n_arena)); //リスト作成
+		return assign(num, n);
+	}
+	json_node<T>* _set_key(_json_key* key, json_node<T>* n) {
+		//共有されたキーで追加または変更
+		size_t num = drop_empty(find(key));
+		if (num != string::npos) delete *nodelist[num].slot;
+		else {
+			_json_key_ref(key);
+			num = add_entry(key);
+		}
+		return assign(num, n);
 	}
 	void delete_object(const string& key) {
 		//指定されたノードを削除
-		json_node<T>** f_node = find(key); //ノードを検索
-		if (f_node != nullptr) {
-			if (*f_node != nullptr) delete *f_node;
-			delete f_node;
-			nodelist.erase(key);
+		size_t num = find(key); //ノードを検索
+		if (num != string::npos) {
+			if (*nodelist[num].slot != nullptr) delete *nodelist[num].slot;
+			erase(num);
 		}
 	}
 	void delete_all() {
 		//すべてのノードを削除
 		if (nodelist.empty()) return;
-		for (auto it : nodelist) {
-			if (*it.second != nullptr) delete *it.second;
-			delete it.second;
+		for (auto& e : nodelist) {
+			if (e.slot == nullptr) continue;
+			if (*e.slot != nullptr) delete *e.slot;
+			_json_key_release(e.key);
+			delete_slot(e.slot);
 		}
 		nodelist.clear();
+		o_index.clear();
+		o_dead = 0;
 	}
 	void delete_empty() {
 		//空のコンテナをすべて削除
 		if (nodelist.empty()) return;
-		for (auto it : nodelist)
-			if (*it.second == nullptr) { delete it.second; nodelist.erase(it.first); }
+		auto emptylist = remove_if(nodelist.begin(), nodelist.end(), [this](_entry& e)->bool {
+			if (e.slot == nullptr) return true;
+			if (*e.slot != nullptr) return false;
+			_json_key_release(e.key);
+			delete_slot(e.slot);
+			return true;
+		});
+		nodelist.erase(emptylist, nodelist.end());
+		o_index.clear();
+		o_dead = 0;
 	}
-	size_t size() { return nodelist.size(); }
+	void reserve(const size_t s) {
+		//索引も予約数に合わせて作成し、追加中の作り直しを避ける
+		nodelist.reserve(s);
+		if (s > linear_max && o_index.size() < s * 2) index_rebuild(s);
+	}
+	size_t size() { return nodelist.size() - o_dead; }
 
-	json_node<T>& operator[](const size_t num) { return *get_object(to_string(num)); }
-	json_node<T>& operator[](const string& str) { return *get_object(str); }
+	using json_node<T>::operator[];
+	json_node<T>& operator[](const size_t num) { return found(get_object(to_string(num))); }
+	json_node<T>& operator[](const string& str) { return found(get_object(str)); }
+	json_node<T>& operator[](const json_key& key) { return found(get_object(key)); }
 };
 
 template <typename T = char>
@@ -254,47 +2389,46 @@ class json_array : public json_node<T> {
 	using json_node<T>::n_parent_pos;
 	using json_node<T>::set_parent;
 	using json_node<T>::reset_parent;
-
+	using json_node<T>::new_slot;
+	using json_node<T>::delete_slot;
 	vector<json_node<T>**> nodelist;
+	_json_print_cache* a_cache; //出力のキャッシュ(print_cached)
 	friend class json_object<T>;
 public:
-	json_array() { reset_parent(); }
-	json_array(const size_t num) { reset_parent(); resize(num); }
+	json_array() : a_cache(nullptr) { reset_parent(); }
+	json_array(const size_t num) : a_cache(nullptr) { reset_parent(); resize(num); }
 	~json_array() {
 		delete_all();
+		delete a_cache;
 		if (n_parent != nullptr) *n_parent_pos = nullptr; //親ノードとの連結を解除
 	}
-	void _print(string& out, const string& indentstr, const int indent) {
-		//指定されたノードを取得
-		out += "[";
-		if (indent > 0) {
-			out += "\n";
-			for (json_node<T>** n : nodelist) {
-				if (*n != nullptr) {
-					for (int i = 0; i < indent; ++i) out += indentstr;
-					(*n)->_print(out, indentstr, indent+1);
-					out += ",\n";
-				}
-			}
-			out.erase(out.end() - 2); //","を削除
-			for (int i = 0; i < indent-1; ++i) out += indentstr;
-		} else {
-			for (json_node<T>** n : nodelist) {
-				if (*n != nullptr) {
-					(*n)->_print(out, indentstr, 0);
-					out += ",";
-				}
-			}
-			out.pop_back(); //","を削除
-		}
-		out += "]";
-		return;
+	void _print(json_writer& w, const int indent) {
+		//JSONテキスト出力
+		if (w.cache_hit(a_cache, indent)) return;
+		const size_t start = w.buf().size(), nocache = w.nocache_count();
+		w.put('[');
+		bool first = true;
+		for (json_node<T>** n : nodelist)
+			if (*n != nullptr) _json_print_member<T>(w, indent, nullptr, *n, first);
+		if (indent > 0 && !first) w.newline(indent-1);
+		w.put(']');
+		w.cache_store(a_cache, start, nocache, indent);
 	}
-	string print(const int indent = 1, const string& indentstr = "\t") {
-		string out;
-		_print(out, indentstr, indent);
-		return out;
+	bool _drop_cache() {
+		if (a_cache == nullptr) return false;
+		delete a_cache;
+		a_cache = nullptr;
+		return true;
 	}
+	json_node<T>* clone() {
+		//空の要素も位置を保って複製
+		json_array<T>* a = new json_array<T>(nodelist.size());
+		for (size_t i = 0; i < nodelist.size(); ++i)
+			if (nodelist[i] != nullptr && *nodelist[i] != nullptr)
+				if (json_node<T>* c = (*nodelist[i])->clone()) a->set_array(i, c);
+		return a;
+	}
+	json_node<T>* _child(const size_t num) { return num < nodelist.size() && nodelist[num] != nullptr ? *nodelist[num] : nullptr; }
 	json_type type() { return Array; }
 	json_node<T>* get_array(const size_t num) {
 		//指定されたノードを取得
@@ -307,7 +2441,7 @@ public:
 		if (num >= nodelist.size()) resize(num+1);
 		if (nodelist[num] != nullptr) { //vectorに存在
 			if (*nodelist[num] != nullptr) delete *nodelist[num]; //中身が存在する場合は削除
-		} else nodelist[num] = new json_node<T>*; //リスト作成
+		} else nodelist[num] = new_slot(); //リスト作成
 		set_parent(n, this, nodelist[num]);
 		*nodelist[num] = n;
 		return n;
@@ -315,31 +2449,31 @@ public:
 	json_node<T>* add_array(json_node<T>* n) {
 		//指定されたノードを追加(既存のノードを代入)
 		size_t pos = nodelist.size();
-		nodelist.push_back(new json_node<T>*); //リスト追加
+		nodelist.push_back(new_slot()); //リスト追加
 		set_parent(n, this, nodelist[pos]);
 		*nodelist[pos] = n;
 		return n;
 	}
 	void delete_array(const size_t num, const int eraseflag = 0) {
 		//指定されたノードを削除
-		if (num < nodelist.size()) return;
+		if (num >= nodelist.size()) return;
 		if (*nodelist[num] != nullptr) delete *nodelist[num];
 		*nodelist[num] = nullptr;
-		if (eraseflag == 1) { delete nodelist[num]; nodelist.erase(nodelist.begin() + num); }
+		if (eraseflag == 1) { delete_slot(nodelist[num]); nodelist.erase(nodelist.begin() + num); }
 	}
 	void delete_all() {
 		//すべてのノードを削除
 		for (json_node<T>** n : nodelist) {
 			if (*n != nullptr) delete *n;
-			delete n;
+			delete_slot(n);
 		}
 		nodelist.clear();
 	}
 	void delete_empty() {
 		//空のコンテナをすべて削除
-		auto emptylist = remove_if(nodelist.begin(), nodelist.end(), [](json_node<T>** n)->bool {
+		auto emptylist = remove_if(nodelist.begin(), nodelist.end(), [this](json_node<T>** n)->bool {
 			if (*n == nullptr) {
-				if (n != nullptr) delete n;
+				if (n != nullptr) delete_slot(n);
 				return true;
 			}
 			return false;
@@ -350,24 +2484,22 @@ public:
 		//リストのリサイズ
 		if (s < nodelist.size()) {
 			//減少分の中身を削除
-			for (size_t i = nodelist.size()-1; i >= s; i--) {
+			for (size_t i = nodelist.size(); i-- > s; ) {
 				if (*nodelist[i] != nullptr) delete *nodelist[i];
-				delete nodelist[i];
+				delete_slot(nodelist[i]);
 			}
 			nodelist.resize(s);
 		} else if (s > nodelist.size()) {
 			size_t bsize = nodelist.size();
 			nodelist.resize(s);
 			//追加分を初期化
-			for (size_t i = bsize; i < s; i++) {
-				nodelist[i] = new json_node<T>*;
-				*nodelist[i] = nullptr;
-			}
+			for (size_t i = bsize; i < s; i++) nodelist[i] = new_slot();
 		}
 	}
+	void reserve(const size_t s) { nodelist.reserve(s); }
 	size_t size() { return nodelist.size(); }
 
-	json_node<T>& operator[](const size_t num) { return *get_array(num); }
+	json_node<T>& operator[](const size_t num) { json_node<T>* n = get_array(num); return n != nullptr ? *n : this->null_node(); }
 };
 
 template <typename T = char>
@@ -381,27 +2513,24 @@ class json_string : public json_node<T> {
 	friend class json_array<T>;
 public:
 	json_string() { reset_parent(); }
-	json_string(const string& arg) { reset_parent(); v = arg; }
+	json_string(const string& arg) : v(arg) { reset_parent(); }
+	json_string(string&& arg) : v(std::move(arg)) { reset_parent(); }
+	json_string(const char* p, const size_t n) : v(p, n) { reset_parent(); }
 	~json_string() { if (n_parent != nullptr) *n_parent_pos = nullptr; } //親ノードとの連結を解除
-	void _print(string& out, const string& indentstr, const int indent) {
-		out += "\"";
-		_json_escape_encode(v, out);
-		out += "\"";
-	}
-	string print(const int indent = 1, const string& indentstr = "\t") {
-		string out;
-		out += "\"";
-		_json_escape_encode(v, out);
-		out += "\"";
-		return out;
-	}
+	void _print(json_writer& w, const int indent) { w.string_value(v); }
+	json_node<T>* clone() { return new json_string<T>(v); }
 	json_type type() { return String; }
 	string get_string() { return v; }
 	double get_number() { return stod(v); }
-	bool get_bool() { return v == "ture" ? true : false; }
-	void set_string(const string& str) { v = str; }
-	void set_number(const double num) { v = to_string(num); }
-	void set_bool(const bool b) { v = b ? "true" : "false"; }
+	bool get_bool() { return v == "true" ? true : false; }
+	bool try_get_string(json_string_view& out) { out = json_string_view(v); return true; }
+	const string& str() const { return v; }
+	void set_string(const string& str) { v = str; this->changed(); }
+	void set_string(string&& str) { v = std::move(str); this->changed(); }
+	void set_number(const double num) { char buf[32]; v.assign(buf, _json_dtoa(num, buf)); this->changed(); }
+	void set_int(const int64_t num) { char buf[32]; v.assign(buf, _json_itoa(num, buf)); this->changed(); }
+	void set_uint(const uint64_t num) { char buf[32]; v.assign(buf, _json_utoa(num, buf)); this->changed(); }
+	void set_bool(const bool b) { v = b ? "true" : "false"; this->changed(); }
 };
 
 template <typename T = char>
@@ -410,22 +2539,41 @@ class json_number : public json_node<T> {
 	using json_node<T>::n_parent_pos;
 	using json_node<T>::reset_parent;
 
-	double v;
+	_json_numval v; //整数は int64 / uint64 のまま保持
 	friend class json_object<T>;
 	friend class json_array<T>;
 public:
-	json_number() { reset_parent(); v = 0; }
-	json_number(double arg) { reset_parent(); v = arg; }
+	json_number() { reset_parent(); }
+	json_number(double arg) { reset_parent(); v.d = arg; }
+	template <typename I> json_number(const I arg, typename enable_if<is_integral<I>::value && is_signed<I>::value, int>::type = 0) { reset_parent(); set_int(arg); }
+	template <typename I> json_number(const I arg, typename enable_if<is_integral<I>::value && !is_signed<I>::value, int>::type = 0) { reset_parent(); set_uint(arg); }
+	json_number(const _json_numval& arg) { reset_parent(); v = arg; }
 	~json_number() { if (n_parent != nullptr) *n_parent_pos = nullptr; }
-	void _print(string& out, const string& indentstr, const int indent) { out += to_string(v); }
-	string print(const int indent = 1, const string& indentstr = "\t") { return to_string(v); }
+	void _print(json_writer& w, const int indent) { char buf[32]; w.append(buf, (size_t)(v.write(buf) - buf)); }
+	json_node<T>* clone() { return new json_number<T>(v); }
 	json_type type() { return Number; }
-	string get_string() { return to_string(v); }
-	double get_number() { return v; }
-	bool get_bool() { return v != 0 ? true : false; }
-	void set_string(const string& str) { v = stod(str); }
-	void set_number(const double num) { v = num; }
-	void set_bool(const bool b) { v = b ? 1 : 0; }
+	string get_string() { return v.to_string(); }
+	double get_number() { return v.to_double(); }
+	int64_t get_int() { return v.clamp_int(); }
+	uint64_t get_uint() { return v.clamp_uint(); }
+	bool get_bool() { return v.kind == 'd' ? v.d != 0 : v.u != 0; }
+	_json_numval get_numval() { return v; }
+	bool try_get_number(double& out) { out = v.to_double(); return true; }
+	bool try_get_int(int64_t& out) { return v.to_int(out); }
+	bool try_get_uint(uint64_t& out) { return v.to_uint(out); }
+	void set_string(const string& str) {
+		size_t pos = 0;
+		if (!_json_parse_number(str, pos, v)) { v.kind = 'd'; v.d = strtod(str.c_str(), nullptr); }
+		this->changed();
+	}
+	void set_number(const double num) { v.kind = 'd'; v.d = num; this->changed(); }
+	void set_int(const int64_t num) { v.kind = 'i'; v.i = num; this->changed(); }
+	void set_uint(const uint64_t num) {
+		if (num <= (uint64_t)INT64_MAX) { v.kind = 'i'; v.i = (int64_t)num; }
+		else { v.kind = 'u'; v.u = num; }
+		this->changed();
+	}
+	void set_bool(const bool b) { set_int(b ? 1 : 0); }
 };
 
 template <typename T = char>
@@ -441,15 +2589,16 @@ public:
 	json_boolean() { reset_parent(); v = false; }
 	json_boolean(bool arg) { reset_parent(); v = arg; }
 	~json_boolean() { if (n_parent != nullptr) *n_parent_pos = nullptr; } //親ノードとの連結を解除
-	void _print(string& out, const string& indentstr, const int indent) { out += v ? "true" : "false"; }
-	string print(const int indent = 1, const string& indentstr = "\t") { return v ? "true" : "false"; }
+	void _print(json_writer& w, const int indent) { if (v) w.append("true", 4); else w.append("false", 5); }
+	json_node<T>* clone() { return new json_boolean<T>(v); }
 	json_type type() { return Boolean; }
 	string get_string() { return v ? "true" : "false"; }
 	double get_number() { return v ? 1 : 0; }
 	bool get_bool() { return v; }
-	void set_string(const string& str) { v = (str == "true") ? true : false; }
-	void set_number(const double num) { v = (num != 0) ? true : false; }
-	void set_bool(const bool b) { v = b; }
+	bool try_get_bool(bool& out) { out = v; return true; }
+	void set_string(const string& str) { v = (str == "true") ? true : false; this->changed(); }
+	void set_number(const double num) { v = (num != 0) ? true : false; this->changed(); }
+	void set_bool(const bool b) { v = b; this->changed(); }
 };
 
 template <typename T = char>
@@ -463,162 +2612,3048 @@ class json_null : public json_node<T> {
 public:
 	json_null() { reset_parent(); }
 	~json_null() { if (n_parent != nullptr) *n_parent_pos = nullptr; } //親ノードとの連結を解除
-	void _print(string& out, const string& indentstr, const int indent) { out += "null"; }
-	string print(const int indent = 1, const string& indentstr = "\t") { return "null"; }
+	void _print(json_writer& w, const int indent) { w.append("null", 4); }
+	json_node<T>* clone() { return new json_null<T>(); }
 	json_type type() { return Null; }
 };
 
-inline json_node<>* _json_parse_type(const string& json, size_t& pos, string& e_temp) {
-	json_node<>* node = nullptr;
-	size_t now = 0;
-	int cnt, flag;
-	string temp;
-	while (pos < json.size()) {
-		switch (json[pos]) {
-			case ' ': case '\n': case '\t': //whitespace
-				++pos;
-				break;
-			case '{': //object
-				node = new json_object<>;
-				++pos; flag = 0; //-1=終了, 0=キーなし, 1=キーあり, 2=ノードあり
-				while (pos < json.size()) {
-					switch (json[pos]) {
-						case ' ': case '\n': case '\t':
+//入力バッファ上の文字列を参照するノード(エスケープを含む場合はget_string時に変換)
+//参照先のバッファはノードより長く保持すること
+template <typename T = char>
+class json_string_ref : public json_node<T> {
+	using json_node<T>::n_parent;
+	using json_node<T>::n_parent_pos;
+	using json_node<T>::reset_parent;
+
+	const char* v_ptr; //nullptrの場合はv_cacheが値
+	size_t v_len;
+	bool v_escaped;
+	string v_cache;
+	friend class json_object<T>;
+	friend class json_array<T>;
+
+	const string& decode() {
+		//エスケープを変換して保持し、以降はv_cacheを使用
+		size_t pos = 0;
+		_json_escape_decode(v_ptr, v_len, pos, v_cache);
+		v_ptr = nullptr;
+		return v_cache;
+	}
+public:
+	json_string_ref(const char* p, const size_t n, const bool escaped) : v_ptr(p), v_len(n), v_escaped(escaped) { reset_parent(); }
+	~json_string_ref() { if (n_parent != nullptr) *n_parent_pos = nullptr; } //親ノードとの連結を解除
+	void _print(json_writer& w, const int indent) {
+		if (v_ptr != nullptr && !v_escaped) w.string_value(v_ptr, v_len);
+		else w.string_value(v_ptr != nullptr ? decode() : v_cache);
+	}
+	json_node<T>* clone() { return new json_string<T>(get_string()); } //参照先のバッファに依存しない文字列として複製
+	json_type type() { return String; }
+	string get_string() {
+		if (v_ptr == nullptr) return v_cache;
+		if (v_escaped) return decode();
+		return string(v_ptr, v_len);
+	}
+	double get_number() { return stod(get_string()); }
+	bool get_bool() { return get_string() == "true"; }
+	bool try_get_string(json_string_view& out) { out = json_string_view(data(), length()); return true; }
+	void set_string(const string& str) { v_cache = str; v_ptr = nullptr; this->changed(); }
+	void set_string(string&& str) { v_cache = std::move(str); v_ptr = nullptr; this->changed(); }
+	void set_number(const double num) { char buf[32]; v_cache.assign(buf, _json_dtoa(num, buf)); v_ptr = nullptr; this->changed(); }
+	void set_bool(const bool b) { v_cache = b ? "true" : "false"; v_ptr = nullptr; this->changed(); }
+	//コピーせずに値を参照(エスケープを含む場合は変換後の値)
+	bool is_view() { return v_ptr != nullptr; }
+	const char* data() { if (v_ptr != nullptr && v_escaped) decode(); return v_ptr != nullptr ? v_ptr : v_cache.data(); }
+	size_t length() { if (v_ptr != nullptr && v_escaped) decode(); return v_ptr != nullptr ? v_len : v_cache.size(); }
+};
+
+//ノードを生成(アリーナが指定された場合はアリーナから確保)
+template <class N, class... A>
+N* _json_new(_json_arena* a, A&&... args) {
+	N* n;
+	if (a == nullptr) n = new N(std::forward<A>(args)...);
+	else {
+		_json_node_header* h = (_json_node_header*)a->allocate(sizeof(_json_node_header) + sizeof(N));
+		h->arena = a;
+		n = ::new ((void*)(h + 1)) N(std::forward<A>(args)...);
+		n->n_arena = a;
+	}
+	_JSON_STAT(++_s->nodes[n->type()]);
+	return n;
+}
+
+//SAXハンドラの基底(必要な関数のみ定義して継承する)
+//関数がfalseを返した場合は読み込みを中断する
+template <class H>
+struct json_sax_handler {
+	//trueの場合は文字列を変換せずにstring_ref(入力上の位置, 長さ, エスケープの有無)で渡す
+	static const bool raw_strings = false;
+	bool string_ref(const char* p, const size_t n, const bool escaped) { return true; }
+	//trueの場合はエスケープを含まないキーをkey_ref(入力上の位置, 長さ)で渡す(エスケープを含むキーはkey)
+	static const bool raw_keys = false;
+	bool key_ref(const char* p, const size_t n) { return true; }
+	bool start_object() { return true; }
+	bool key(const std::string& k) { return true; }
+	bool end_object() { return true; }
+	bool start_array() { return true; }
+	bool end_array() { return true; }
+	bool number(const double v) { return true; }
+	bool integer(const int64_t v) { return static_cast<H*>(this)->number((double)v); }
+	bool uinteger(const uint64_t v) { return static_cast<H*>(this)->number((double)v); }
+	bool boolean(const bool v) { return true; }
+	bool null() { return true; }
+	bool string(const std::string& v) { return true; }
+};
+
+//読み込みのエラーの種類
+enum json_error {
+	json_error_none,
+	json_error_eof,      //入力が途中で終了
+	json_error_syntax,   //予期しない文字
+	json_error_string,   //不正な文字列(制御文字・エスケープ)
+	json_error_number,   //不正な数値
+	json_error_depth,    //深さの上限を超えた
+	json_error_size,     //サイズの上限を超えた
+	json_error_trailing, //値の後に余分な文字がある
+	json_error_handler   //ハンドラが中断した
+};
+inline const char* json_error_message(const json_error e) {
+	switch (e) {
+		case json_error_none: return "no error";
+		case json_error_eof: return "unexpected end of input";
+		case json_error_syntax: return "unexpected character";
+		case json_error_string: return "invalid string";
+		case json_error_number: return "invalid number";
+		case json_error_depth: return "nesting too deep";
+		case json_error_size: return "input too large";
+		case json_error_trailing: return "trailing characters after value";
+		case json_error_handler: return "aborted by handler";
+	}
+	return "unknown error";
+}
+
+//深さの上限の既定値
+static const size_t json_default_max_depth = 10000;
+
+//読み込みの状態(コンテナのスタックは読み込みごとに再利用)
+struct _json_parse_context {
+	vector<char> stack; //'{' または '['
+	size_t max_depth;
+	json_error error;
+	size_t error_pos;
+
+	_json_parse_context(const size_t depth = json_default_max_depth) : max_depth(depth), error(json_error_none), error_pos(0) {}
+	bool fail(const json_error e, const size_t pos) { error = e; error_pos = pos; return false; }
+};
+
+//JSONの文法に従ってハンドラを呼び出す(再帰せずにスタックで入れ子を管理)
+template <class H>
+bool _json_sax_parse_iter(const char* json, const size_t n, size_t& pos, string& e_temp, _json_parse_context& c, H& h) {
+	enum { s_value, s_key, s_next } state = s_value;
+	vector<char>& stack = c.stack;
+	_json_numval num;
+	stack.clear();
+	c.error = json_error_none;
+	for (;;) {
+		pos = _json_skip_ws(json, pos, n);
+		if (pos >= n) return c.fail(json_error_eof, pos);
+		switch (state) {
+			case s_value:
+				switch (json[pos]) {
+					case '{': case '[': {
+						//コンテナの開始(空の場合はそのまま終了)
+						const char open = json[pos];
+						if (stack.size() >= c.max_depth) return c.fail(json_error_depth, pos);
+						if (!(open == '{' ? h.start_object() : h.start_array())) return c.fail(json_error_handler, pos);
+						stack.push_back(open);
+						pos = _json_skip_ws(json, pos + 1, n);
+						if (pos < n && json[pos] == (open == '{' ? '}' : ']')) {
 							++pos;
-							break;
-						case '\"':
-							//キー作成
-							if (flag == 0) {
-								++pos; flag = 1;
-								temp = _json_escape_decode(json, pos, e_temp);
-							} else { delete node; return nullptr; }
-							break;
-						case ':':
-							//ノード作成
-							if (flag == 1) {
-								++pos;
-								if (node->set_object(temp, _json_parse_type(json, pos, e_temp)) == nullptr) { delete node; return nullptr; } //ノード作成失敗
-								flag = 2;
-							} else { delete node; return nullptr; }
-							break;
-						case ',':
-							//ノード確定処理
-							if (flag == 2) { ++pos; flag = 0; }
-							else { delete node; return nullptr; }
-							break;
-						case '}':
-							//終了
-							if (flag == 2 || node->size() == 0) { ++pos; return node; }
-							delete node;
-							return nullptr;
-						default:
-							delete node;
-							return nullptr;
+							stack.pop_back();
+							if (!(open == '{' ? h.end_object() : h.end_array())) return c.fail(json_error_handler, pos - 1);
+							state = s_next;
+							if (stack.empty()) return true;
+						} else state = open == '{' ? s_key : s_value;
+						continue;
 					}
-				}
-				delete node;
-				return nullptr;
-			case '[': //array
-				node = new json_array<>;
-				++pos; flag = 0; //-1=終了, 0=ノードなし, 1=ノードあり
-				while (pos < json.size()) {
-					switch (json[pos]) {
-						case ' ': case '\n': case '\t':
-							++pos;
-							break;
-						case ',':
-							//ノード確定処理
-							if (flag == 1) { ++pos; flag = 0; }
-							else { delete node; return nullptr; }
-							break;
-						case ']':
-							//終了
-							if (flag == 1 || node->size() == 0) { ++pos; return node; }
-							delete node;
-							return nullptr;
-						default:
-							if (flag == 0) {
-								//ノード作成
-								if (node->add_array(_json_parse_type(json, pos, e_temp)) == nullptr) { delete node; return nullptr; } //ノード作成失敗
-								flag = 1;
-							} else { delete node; return nullptr; }
-							break;
+					case '\"': { //string
+						const size_t start = ++pos;
+						if (H::raw_strings) {
+							bool escaped;
+							if (!_json_skip_string(json, n, pos, escaped)) return c.fail(pos >= n ? json_error_eof : json_error_string, pos);
+							if (!h.string_ref(json + start, pos - start - 1, escaped)) return c.fail(json_error_handler, start - 1);
+						} else {
+							{
+								_JSON_STAT_TIMER(ns_strings);
+								if (!_json_unescape(json, n, pos, e_temp)) return c.fail(pos >= n ? json_error_eof : json_error_string, pos);
+							}
+							if (!h.string(e_temp)) return c.fail(json_error_handler, start - 1);
+						}
+						break;
 					}
+					case '-':
+					case '0': case '1': case '2': case '3': case '4':
+					case '5': case '6': case '7': case '8': case '9': { //number
+						const size_t start = pos;
+						{
+							_JSON_STAT_TIMER(ns_numbers);
+							if (!_json_parse_number(json, n, pos, num)) return c.fail(json_error_number, start);
+						}
+						if (!(num.kind == 'd' ? h.number(num.d) : num.kind == 'i' ? h.integer(num.i) : h.uinteger(num.u))) return c.fail(json_error_handler, start);
+						break;
+					}
+					case 't': //boolean true
+						if (pos+4 > n) return c.fail(json_error_eof, n);
+						if (memcmp(json+pos+1, "rue", 3) != 0) return c.fail(json_error_syntax, pos);
+						if (!h.boolean(true)) return c.fail(json_error_handler, pos);
+						pos += 4;
+						break;
+					case 'f': //boolean false
+						if (pos+5 > n) return c.fail(json_error_eof, n);
+						if (memcmp(json+pos+1, "alse", 4) != 0) return c.fail(json_error_syntax, pos);
+						if (!h.boolean(false)) return c.fail(json_error_handler, pos);
+						pos += 5;
+						break;
+					case 'n': //null
+						if (pos+4 > n) return c.fail(json_error_eof, n);
+						if (memcmp(json+pos+1, "ull", 3) != 0) return c.fail(json_error_syntax, pos);
+						if (!h.null()) return c.fail(json_error_handler, pos);
+						pos += 4;
+						break;
+					default: return c.fail(json_error_syntax, pos);
+				}
+				state = s_next;
+				break;
+			case s_key: {
+				//キーと:
+				if (json[pos] != '\"') return c.fail(json_error_syntax, pos);
+				const size_t start = ++pos;
+				bool escaped = true;
+				{
+					_JSON_STAT_TIMER(ns_strings);
+					if (H::raw_keys && !_json_skip_string(json, n, pos, escaped)) return c.fail(pos >= n ? json_error_eof : json_error_string, pos);
+					if (escaped && !_json_unescape(json, n, pos = start, e_temp)) return c.fail(pos >= n ? json_error_eof : json_error_string, pos);
 				}
-				delete node;
-				return nullptr;
-			case '\"': //string
+				if (!(escaped ? h.key(e_temp) : h.key_ref(json + start, pos - start - 1))) return c.fail(json_error_handler, start - 1);
+				pos = _json_skip_ws(json, pos, n);
+				if (pos >= n) return c.fail(json_error_eof, pos);
+				if (json[pos] != ':') return c.fail(json_error_syntax, pos);
 				++pos;
-				return new json_string<>(_json_escape_decode(json, pos, e_temp));
+				state = s_value;
+				break;
+			}
+			case s_next:
+				//値の後(,または終了)
+				if (json[pos] == ',') {
+					++pos;
+					state = stack.back() == '{' ? s_key : s_value;
+				} else if (json[pos] == (stack.back() == '{' ? '}' : ']')) {
+					const char open = stack.back();
+					stack.pop_back();
+					if (!(open == '{' ? h.end_object() : h.end_array())) return c.fail(json_error_handler, pos);
+					++pos;
+				} else return c.fail(json_error_syntax, pos);
+				break;
+		}
+		if (state == s_next && stack.empty()) return true;
+	}
+}
+template <class H>
+bool _json_sax_parse_type(const char* json, const size_t n, size_t& pos, string& e_temp, H& h) {
+	_json_parse_context c;
+	return _json_sax_parse_iter(json, n, pos, e_temp, c, h);
+}
+
+//utf8 BOMを読み飛ばした位置
+inline size_t _json_skip_bom(const char* json, const size_t n) {
+	const unsigned char* bom = (const unsigned char*)json;
+	return (n >= 3 && bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF) ? 3 : 0;
+}
+
+//SAX形式の読み込み(ノードを作成せずにハンドラを呼び出す)
+template <class H>
+bool json_sax_parse(const char* json, const size_t n, H& handler) {
+	size_t pos = _json_skip_bom(json, n);
+	string e_temp;
+	return _json_sax_parse_type(json, n, pos, e_temp, handler);
+}
+template <class H>
+bool json_sax_parse(const string& json, H& handler) { return json_sax_parse(json.data(), json.size(), handler); }
+
+//ノードを作成するSAXハンドラ
+class _json_dom_handler : public json_sax_handler<_json_dom_handler> {
+protected:
+	_json_arena* d_arena;
+	json_node<>* d_root;
+	vector<json_node<>*> d_stack;
+	std::string d_key;
+	json_key_table* d_keys; //キーの共有表(nullptrは共有しない)
+	_json_key* d_ikey;
+	deque<json_node<>*>* d_values;
+
+	bool add(json_node<>* n, const bool container = false) {
+		if (d_stack.empty()) {
+			if (d_root != nullptr) { delete n; return false; }
+			d_root = n;
+			if (!container) done();
+			return true;
+		}
+		if (d_stack.back()->type() == Object) {
+			if (d_ikey != nullptr) d_stack.back()->_set_key(d_ikey, n);
+			else d_stack.back()->set_object(d_key, n);
+		}
+		else d_stack.back()->add_array(n);
+		return true;
+	}
+	void done() {
+		//複数の値を読み込む場合は完成した値をリストに追加
+		if (d_values != nullptr) { d_values->push_back(d_root); d_root = nullptr; }
+	}
+public:
+	_json_dom_handler(_json_arena* arena = nullptr, deque<json_node<>*>* values = nullptr, json_key_table* keys = nullptr) : d_arena(arena), d_root(nullptr), d_keys(keys), d_ikey(nullptr), d_values(values) {}
+	~_json_dom_handler() { clear(); }
+	bool start_object() {
+		json_node<>* n = _json_new<json_object<>>(d_arena);
+		if (!add(n, true)) return false;
+		d_stack.push_back(n);
+		_JSON_STAT(if (d_stack.size() > _s->max_depth) _s->max_depth = d_stack.size());
+		return true;
+	}
+	bool start_array() {
+		json_node<>* n = _json_new<json_array<>>(d_arena);
+		if (!add(n, true)) return false;
+		d_stack.push_back(n);
+		_JSON_STAT(if (d_stack.size() > _s->max_depth) _s->max_depth = d_stack.size());
+		return true;
+	}
+	bool end_object() { d_stack.pop_back(); if (d_stack.empty()) done(); return true; }
+	bool end_array() { d_stack.pop_back(); if (d_stack.empty()) done(); return true; }
+	bool key(const std::string& k) {
+		//共有表が上限に達した場合はノードごとにキーを作成
+		d_ikey = d_keys != nullptr ? d_keys->find_or_add(k.data(), k.size(), _json_hash_key(k.data(), k.size())) : nullptr;
+		if (d_ikey == nullptr) d_key = k;
+		return true;
+	}
+	bool string(const std::string& v) { return add(_json_new<json_string<>>(d_arena, v)); }
+	bool number(const double v) { return add(_json_new<json_number<>>(d_arena, v)); }
+	bool integer(const int64_t v) { return add(_json_new<json_number<>>(d_arena, v)); }
+	bool uinteger(const uint64_t v) { return add(_json_new<json_number<>>(d_arena, v)); }
+	bool boolean(const bool v) { return add(_json_new<json_boolean<>>(d_arena, v)); }
+	bool null() { return add(_json_new<json_null<>>(d_arena)); }
+	//作成したノードの所有権を渡す
+	json_node<>* release() {
+		json_node<>* n = d_root;
+		d_root = nullptr;
+		d_stack.clear();
+		return n;
+	}
+	void clear() {
+		if (d_root != nullptr) delete d_root;
+		d_root = nullptr;
+		d_stack.clear();
+	}
+};
+
+//文字列を入力バッファの参照(json_string_ref)として作成するSAXハンドラ
+class _json_view_handler : public _json_dom_handler {
+public:
+	static const bool raw_strings = true;
+	static const bool raw_keys = true;
+	_json_view_handler(_json_arena* arena, json_key_table* keys = nullptr) : _json_dom_handler(arena, nullptr, keys) {}
+	bool string_ref(const char* p, const size_t n, const bool escaped) { return add(_json_new<json_string_ref<>>(d_arena, p, n, escaped)); }
+	bool key_ref(const char* p, const size_t n) {
+		//共有表を使用しない場合は入力を参照するキー(アリーナに作成)
+		const uint32_t h = _json_hash_key(p, n);
+		d_ikey = d_keys != nullptr ? d_keys->find_or_add(p, n, h) : _json_key_view(p, n, h, d_arena);
+		if (d_ikey == nullptr) d_key.assign(p, n);
+		return true;
+	}
+};
+
+inline json_node<>* _json_parse_type(const char* json, const size_t n, size_t& pos, string& e_temp, _json_arena* arena = nullptr, json_key_table* keys = nullptr) {
+	_json_dom_handler h(arena, nullptr, keys);
+	if (!_json_sax_parse_type(json, n, pos, e_temp, h)) return nullptr;
+	return h.release();
+}
+inline json_node<>* _json_parse_type(const string& json, size_t& pos, string& e_temp, _json_arena* arena = nullptr, json_key_table* keys = nullptr) { return _json_parse_type(json.data(), json.size(), pos, e_temp, arena, keys); }
+
+//コンテナを括弧と文字列の範囲の判定だけで読み飛ばす(posは先頭の括弧、成功した場合は終端の括弧の次)
+//入れ子の深さがmax_depthを超える場合は失敗
+inline bool _json_skip_container(const char* json, const size_t n, size_t& pos, const size_t max_depth = json_default_max_depth) {
+	const char* p = json + pos;
+	const size_t len = n - pos;
+	_json_stage1 s(json_simd_level());
+	size_t depth = 0;
+	for (size_t base = 0; base < len; base += 64) {
+		s.next(p, base, len);
+		uint64_t bits = s.b.op & ~s.in_string;
+		while (bits != 0) {
+			size_t i = base + _json_ctz64(bits);
+			bits &= bits - 1;
+			char c = p[i];
+			if (c == '{' || c == '[') { if (++depth > max_depth) return false; }
+			else if ((c == '}' || c == ']') && --depth == 0) {
+				pos += i + 1;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+inline json_node<>* _json_lazy_materialize(const char* json, const size_t n, _json_arena* arena);
+
+//未解析のコンテナ(最初に要素を参照した時に直下の要素を読み込み、以降はそのノードへ委譲)
+//読み込みに失敗した場合は空のコンテナとして扱う
+template <typename T = char>
+class json_lazy : public json_node<T> {
+	using json_node<T>::n_parent;
+	using json_node<T>::n_parent_pos;
+	using json_node<T>::reset_parent;
+
+	const char* l_ptr;
+	size_t l_len;
+	json_node<T>* l_node;
+	bool l_failed;
+
+	json_node<T>* get() {
+		if (l_node == nullptr && !l_failed) {
+			//並列出力では各スレッドが同じドキュメントのアリーナから読み込むため排他する
+			unique_lock<mutex> lk;
+			if (this->n_arena != nullptr) lk = unique_lock<mutex>(this->n_arena->lock());
+			l_node = _json_lazy_materialize(l_ptr, l_len, this->n_arena);
+			l_failed = l_node == nullptr;
+		}
+		return l_node;
+	}
+public:
+	json_lazy(const char* p, const size_t n) : l_ptr(p), l_len(n), l_node(nullptr), l_failed(false) { reset_parent(); }
+	~json_lazy() {
+		if (l_node != nullptr) delete l_node;
+		if (n_parent != nullptr) *n_parent_pos = nullptr; //親ノードとの連結を解除
+	}
+	//読み込み済みか
+	bool materialized() const { return l_node != nullptr; }
+	bool failed() { return get() == nullptr; }
+
+	void _print(json_writer& w, const int indent) {
+		w.no_cache(); //読み込み後の変更は親ノードへ伝わらないためキャッシュしない
+		if (get() != nullptr) l_node->_print(w, indent);
+		else w.append(l_ptr[0] == '{' ? "{}" : "[]", 2);
+	}
+	json_type type() { return l_ptr[0] == '{' ? Object : Array; }
+	json_node<T>* clone() {
+		//失敗した場合は出力と同じく空のコンテナとして複製
+		if (get() != nullptr) return l_node->clone();
+		return l_ptr[0] == '{' ? (json_node<T>*)new json_object<T> : (json_node<T>*)new json_array<T>;
+	}
+	using json_node<T>::get_object;
+	json_node<T>* get_object(const string& key) { return get() != nullptr ? l_node->get_object(key) : nullptr; }
+	json_node<T>* get_object(const json_key& key) { return get() != nullptr ? l_node->get_object(key) : nullptr; }
+	json_node<T>* get_object(const char* key, const size_t len) { return get() != nullptr ? l_node->get_object(key, len) : nullptr; }
+	json_node<T>* get_array(const size_t num) { return get() != nullptr ? l_node->get_array(num) : nullptr; }
+	using json_node<T>::set_object;
+	json_node<T>* set_object(const string& key, json_node<T>* n) { return get() != nullptr ? l_node->set_object(key, n) : nullptr; }
+	json_node<T>* set_object(const char* key, const size_t len, json_node<T>* n) { return get() != nullptr ? l_node->set_object(key, len, n) : nullptr; }
+	json_node<T>* _set_key(_json_key* key, json_node<T>* n) { return get() != nullptr ? l_node->_set_key(key, n) : nullptr; }
+	json_node<T>* set_array(const size_t num, json_node<T>* n) { return get() != nullptr ? l_node->set_array(num, n) : nullptr; }
+	json_node<T>* add_array(json_node<T>* n) { return get() != nullptr ? l_node->add_array(n) : nullptr; }
+	void delete_object(const string& key) { if (get() != nullptr) l_node->delete_object(key); }
+	void delete_array(const size_t num, const int eraseflag = 0) { if (get() != nullptr) l_node->delete_array(num, eraseflag); }
+	void delete_all() { if (get() != nullptr) l_node->delete_all(); }
+	void delete_empty() { if (get() != nullptr) l_node->delete_empty(); }
+	void resize(const size_t s) { if (get() != nullptr) l_node->resize(s); }
+	void reserve(const size_t s) { if (get() != nullptr) l_node->reserve(s); }
+	size_t size() { return get() != nullptr ? l_node->size() : 0; }
+	json_node<T>* _child(const size_t num) { return get() != nullptr ? l_node->_child(num) : nullptr; }
+	const _json_key* _child_key(const size_t num) { return get() != nullptr ? l_node->_child_key(num) : nullptr; }
+
+	using json_node<T>::operator[];
+	json_node<T>& operator[](const size_t num) { return get() != nullptr ? (*l_node)[num] : this->null_node(); }
+	json_node<T>& operator[](const string& str) { return get() != nullptr ? (*l_node)[str] : this->null_node(); }
+	json_node<T>& operator[](const json_key& key) { return get() != nullptr ? (*l_node)[key] : this->null_node(); }
+};
+
+//値を1つ読み込み、コンテナは範囲だけを記録したjson_lazyとして作成
+inline json_node<>* _json_lazy_value(const char* json, const size_t n, size_t& pos, string& e_temp, _json_arena* arena) {
+	pos = _json_skip_ws(json, pos, n);
+	if (pos < n && (json[pos] == '{' || json[pos] == '[')) {
+		size_t begin = pos;
+		if (!_json_skip_container(json, n, pos)) return nullptr;
+		return _json_new<json_lazy<>>(arena, json + begin, pos - begin);
+	}
+	return _json_parse_type(json, n, pos, e_temp, arena);
+}
+
+//コンテナの直下の要素だけを読み込む(入れ子のコンテナはjson_lazy)
+inline json_node<>* _json_lazy_materialize(const char* json, const size_t n, _json_arena* arena) {
+	string e_temp;
+	size_t pos = 0;
+	const bool object = json[0] == '{';
+	json_node<>* c = object ? (json_node<>*)_json_new<json_object<>>(arena) : (json_node<>*)_json_new<json_array<>>(arena);
+	pos = _json_skip_ws(json, 1, n);
+	if (pos < n && json[pos] == (object ? '}' : ']')) return c;
+	while (pos < n) {
+		string key;
+		if (object) {
+			if (json[pos] != '\"') break;
+			++pos;
+			if (!_json_unescape(json, n, pos, e_temp)) break;
+			key.swap(e_temp);
+			pos = _json_skip_ws(json, pos, n);
+			if (pos >= n || json[pos] != ':') break;
+			++pos;
+		}
+		json_node<>* v = _json_lazy_value(json, n, pos, e_temp, arena);
+		if (v == nullptr) break;
+		if (object) c->set_object(key, v);
+		else c->add_array(v);
+		pos = _json_skip_ws(json, pos, n);
+		if (pos >= n) break;
+		if (json[pos] == (object ? '}' : ']')) {
+			if (pos + 1 == n) return c;
+			break;
+		}
+		if (json[pos] != ',') break;
+		pos = _json_skip_ws(json, pos + 1, n);
+	}
+	delete c;
+	return nullptr;
+}
+
+//分割された入力を順に読み込み、ハンドラを呼び出すパーサー
+//文字列、\uエスケープ、数値の途中で分割されていても状態を保持して続きから読み込む
+template <class H>
+class json_sax_push_parser {
+	enum state { s_value, s_value_or_end, s_key_or_end, s_key, s_colon, s_after, s_string, s_number, s_literal, s_error };
+	H& p_h;
+	vector<char> p_stack;
+	string p_str, p_tok;
+	state p_state;
+	int p_sstate; //文字列内の状態(0=通常, 1=\の後, 2=\uの16進数, 3=上位サロゲートの後, 4=上位サロゲートと\の後)
+	bool p_key;
+	bool p_sep; //トップレベルの数値・リテラルの直後(空白か構造文字が必要)
+	int p_bom;  //先頭のBOMの一致したバイト数(-1=判定済み)
+	const char* p_lit;
+	int p_litpos, p_hexcnt;
+	long p_hex, p_high;
+	size_t p_offset, p_error, p_max_depth;
+	json_error p_code;
+
+	bool fail(const size_t i, const json_error e = json_error_syntax) { p_state = s_error; p_error = p_offset + i; if (p_code == json_error_none) p_code = e; return false; }
+	//エラーの種類を記録してfalse(位置はfailで記録)
+	bool error_kind(const json_error e) { p_code = e; return false; }
+	bool after_value(const bool scalar = false) {
+		p_state = p_stack.empty() ? s_value : s_after;
+		p_sep = scalar && p_stack.empty();
+		return true;
+	}
+	bool close(const char c) {
+		if (p_stack.empty() || p_stack.back() != (c == '}' ? '{' : '[')) return false;
+		p_stack.pop_back();
+		if (!(c == '}' ? p_h.end_object() : p_h.end_array())) return error_kind(json_error_handler);
+		return after_value();
+	}
+	bool begin_value(const char c) {
+		if ((c == '{' || c == '[') && p_stack.size() >= p_max_depth) return error_kind(json_error_depth);
+		switch (c) {
+			case '{':
+				if (!p_h.start_object()) return error_kind(json_error_handler);
+				p_stack.push_back('{'); p_state = s_key_or_end;
+				return true;
+			case '[':
+				if (!p_h.start_array()) return error_kind(json_error_handler);
+				p_stack.push_back('['); p_state = s_value_or_end;
+				return true;
+			case '\"':
+				p_key = false; p_str.clear(); p_sstate = 0; p_high = -1; p_state = s_string;
+				return true;
 			case '-':
-				//number - (次の文字が数字以外の場合はエラー)
-				if (pos+1 < json.size() && (json[pos+1] < 0x30 || json[pos+1] > 0x39)) return nullptr;
-				now = 1;
 			case '0': case '1': case '2': case '3': case '4':
 			case '5': case '6': case '7': case '8': case '9':
-				//number
-				flag = 0; cnt = 0; now += pos; //flag(-1=数字終了, 0=整数, 1=小数点, 2=指数) ,cnt(数字カウント)
-				while (now < json.size()) {
-					switch (json[now]) {
-						case ' ': case '\t': case '\n':
-							++now;
-						case ',':
-							//終了
-							node = new json_number<>( stod( json.substr(pos, now-pos) ) );
-							pos = now;
-							return node;
-						case 'e':
-						case 'E': // e, E, e+, e-, E+, E-
-							//指数モードに変更
-							if ((flag == 0 || flag == 1) && cnt > 0 && now+1 < json.size() && (json[now+1] == '-' || json[now+1] == '+' || (json[now+1] >= 0x30 && json[now+1] <= 0x39))) {
-								flag = 2; cnt = 0; now += 2;
-							} else return nullptr;
-							break;
-						case '.':
-							//小数点モードに変更
-							if (flag != 0 || cnt == 0) return nullptr; //整数モード以外の場合はエラー
-							flag = 1; cnt = 0; ++now;
-							break;
-						case '0':
-							//整数モードの最初の文字が0 + 次の文字が数字の場合はエラー
-							if (cnt == 0 && flag == 0 && now+1 < json.size() && json[now+1] >= 0x30 && json[now+1] <= 0x39) return nullptr;
-						case '1': case '2': case '3': case '4': case '5':
-						case '6': case '7': case '8': case '9':
-							++cnt; ++now;
-							break;
-						default: return nullptr;
-					}
-				}
-				return nullptr;
-			case 't': //boolean true
-				if (json.compare(pos+1, 3, "rue") == 0) {
-					pos += 4;
-					return new json_boolean<>(true);
-				}
-				return nullptr;
-			case 'f': //boolean false
-				if (json.compare(pos+1, 4, "alse") == 0) {
-					pos += 5;
-					return new json_boolean<>(false);
-				}
-				return nullptr;
-			case 'n': //null
-				if (json.compare(pos+1, 3, "ull") == 0) {
-					pos += 4;
-					return new json_null<>;
+				p_tok.assign(1, c); p_state = s_number;
+				return true;
+			case 't': p_lit = "true"; p_litpos = 1; p_state = s_literal; return true;
+			case 'f': p_lit = "false"; p_litpos = 1; p_state = s_literal; return true;
+			case 'n': p_lit = "null"; p_litpos = 1; p_state = s_literal; return true;
+			default: return false;
+		}
+	}
+	bool end_number() {
+		_json_numval num;
+		size_t pos = 0;
+		if (!_json_parse_number(p_tok, pos, num) || pos != p_tok.size()) return error_kind(json_error_number);
+		if (!(num.kind == 'd' ? p_h.number(num.d) : num.kind == 'i' ? p_h.integer(num.i) : p_h.uinteger(num.u))) return error_kind(json_error_handler);
+		return after_value(true);
+	}
+	bool end_literal() {
+		if (!(p_lit[0] == 'n' ? p_h.null() : p_h.boolean(p_lit[0] == 't'))) return error_kind(json_error_handler);
+		return after_value(true);
+	}
+	void code_point() {
+		//\uXXXXが揃った時点の処理(サロゲートペアは下位を待って結合)
+		long cp = p_hex;
+		p_sstate = 0;
+		if (p_high >= 0) {
+			if (cp >= 0xDC00 && cp <= 0xDFFF) {
+				_json_utf8_append((unsigned long)(0x10000 + ((p_high - 0xD800) << 10) + (cp - 0xDC00)), p_str);
+				p_high = -1;
+				return;
+			}
+			_json_utf8_append((unsigned long)p_high, p_str);
+			p_high = -1;
+		}
+		if (cp >= 0xD800 && cp <= 0xDBFF) { p_high = cp; p_sstate = 3; return; }
+		_json_utf8_append((unsigned long)cp, p_str);
+	}
+	bool feed_string(const char* p, size_t& i, const size_t n) {
+		while (i < n) {
+			if (p_sstate == 0) {
+				//エスケープ不要な範囲はまとめてコピー
+				size_t e = _json_scan_string(p, i, n, false);
+				p_str.append(p + i, e - i);
+				i = e;
+				if (i >= n) return true;
+				const char c = p[i++];
+				if (c == '\"') {
+					if (p_key) { p_state = s_colon; return p_h.key(p_str) || error_kind(json_error_handler); }
+					return p_h.string(p_str) ? after_value() : error_kind(json_error_handler);
 				}
-				return nullptr;
-			default: return nullptr;
+				if (c != '\\') return error_kind(json_error_string); //制御文字
+				p_sstate = 1;
+				continue;
+			}
+			const char c = p[i++];
+			long v;
+			switch (p_sstate) {
+				case 1:
+					p_sstate = 0;
+					switch (c) {
+						case '\"': p_str += '\"'; break;
+						case '\\': p_str += '\\'; break;
+						case '/':  p_str += '/';  break;
+						case 'b':  p_str += '\b'; break;
+						case 'f':  p_str += '\f'; break;
+						case 'n':  p_str += '\n'; break;
+						case 'r':  p_str += '\r'; break;
+						case 't':  p_str += '\t'; break;
+						case 'u':  p_hex = 0; p_hexcnt = 0; p_sstate = 2; break;
+						default: return error_kind(json_error_string);
+					}
+					break;
+				case 2:
+					if ((v = _json_hex1(c)) < 0) return error_kind(json_error_string);
+					p_hex = (p_hex << 4) | v;
+					if (++p_hexcnt == 4) code_point();
+					break;
+				case 3:
+					if (c == '\\') { p_sstate = 4; break; }
+					_json_utf8_append((unsigned long)p_high, p_str);
+					p_high = -1; p_sstate = 0; --i;
+					break;
+				case 4:
+					if (c == 'u') { p_hex = 0; p_hexcnt = 0; p_sstate = 2; break; }
+					_json_utf8_append((unsigned long)p_high, p_str);
+					p_high = -1; p_sstate = 1; --i;
+					break;
+			}
 		}
+		return true;
 	}
-	return nullptr;
-}
+public:
+	json_sax_push_parser(H& handler, const size_t max_depth = json_default_max_depth) : p_h(handler), p_max_depth(max_depth) { reset(); }
+	void reset() {
+		p_stack.clear();
+		p_state = s_value;
+		p_sep = false;
+		p_bom = 0;
+		p_sstate = 0;
+		p_high = -1;
+		p_offset = 0;
+		p_error = 0;
+		p_code = json_error_none;
+	}
+	//入れ子の深さの上限(超えた場合はjson_error_depth)
+	void set_max_depth(const size_t depth) { p_max_depth = depth; }
+	//入力の追加(エラーの場合はfalse)
+	bool feed(const char* p, const size_t n) {
+		size_t i = 0;
+		if (p_state == s_error) return false;
+		//先頭のBOMを読み飛ばす(分割されていてもよい)
+		for (; p_bom >= 0 && i < n; ++i) {
+			if (p[i] != "\xEF\xBB\xBF"[p_bom]) {
+				if (p_bom > 0) return fail(0 - p_offset); //途中までのBOM
+				p_bom = -1;
+				break;
+			}
+			if (++p_bom == 3) p_bom = -1;
+		}
+		while (i < n) {
+			const char c = p[i];
+			switch (p_state) {
+				case s_string:
+					if (!feed_string(p, i, n)) return fail(i-1); //エラーの文字の位置
+					continue;
+				case s_number:
+					if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') { p_tok += c; ++i; continue; }
+					if (!end_number()) return fail(i - p_tok.size()); //数値の先頭の位置
+					continue;
+				case s_literal:
+					if (c != p_lit[p_litpos]) return fail(i);
+					++i;
+					if (p_lit[++p_litpos] == '\0' && !end_literal()) return fail(i);
+					continue;
+				default: break;
+			}
+			if (c == ' ' || c == '\n' || c == '\t' || c == '\r') { p_sep = false; i = _json_skip_ws(p, i, n); continue; }
+			if (p_sep) {
+				//数値・リテラルが区切り無しで続く場合(true1など)はエラー
+				p_sep = false;
+				if (c != '{' && c != '}' && c != '[' && c != ']' && c != ',' && c != ':') return fail(i);
+			}
+			++i;
+			switch (p_state) {
+				case s_value_or_end:
+					if (c == ']') { if (!close(c)) return fail(i-1); break; }
+				case s_value:
+					if (!begin_value(c)) return fail(i-1);
+					break;
+				case s_key_or_end:
+					if (c == '}') { if (!close(c)) return fail(i-1); break; }
+				case s_key:
+					if (c != '\"') return fail(i-1);
+					p_key = true; p_str.clear(); p_sstate = 0; p_high = -1; p_state = s_string;
+					break;
+				case s_colon:
+					if (c != ':') return fail(i-1);
+					p_state = s_value;
+					break;
+				case s_after:
+					if (c == ',') { p_state = p_stack.back() == '{' ? s_key : s_value; break; }
+					if ((c != '}' && c != ']') || !close(c)) return fail(i-1);
+					break;
+				default: return fail(i-1);
+			}
+		}
+		p_offset += n;
+		return true;
+	}
+	bool feed(const string& s) { return feed(s.data(), s.size()); }
+	//入力の終了(値の途中で終わった場合はfalse)
+	bool finish() {
+		if (p_state == s_number && p_stack.size() == 0 && !end_number()) return fail(0 - p_tok.size()); //数値の先頭の位置
+		return p_state == s_value && p_stack.empty() && p_bom <= 0;
+	}
+	bool error() const { return p_state == s_error; }
+	size_t error_offset() const { return p_error; }
+	json_error error_code() const { return p_code; }
+	size_t depth() const { return p_stack.size(); }
+};
+
+//分割された入力からノードを作成するパーサー
+//完成したトップレベルの値から順に取り出せる
+class json_push_parser {
+	deque<json_node<>*> p_values;
+	_json_dom_handler p_handler;
+	json_sax_push_parser<_json_dom_handler> p_parser;
+public:
+	json_push_parser(_json_arena* arena = nullptr, json_key_table* keys = nullptr, const size_t max_depth = json_default_max_depth) : p_handler(arena, &p_values, keys), p_parser(p_handler, max_depth) {}
+	~json_push_parser() { for (json_node<>* n : p_values) delete n; }
+	json_push_parser(const json_push_parser&) = delete;
+	json_push_parser& operator=(const json_push_parser&) = delete;
+
+	bool feed(const char* p, const size_t n) { return p_parser.feed(p, n); }
+	bool feed(const string& s) { return p_parser.feed(s.data(), s.size()); }
+	bool finish() { return p_parser.finish(); }
+	size_t available() const { return p_values.size(); }
+	//完成した値の取り出し(所有権は呼び出し側に移る)
+	json_node<>* next() {
+		if (p_values.empty()) return nullptr;
+		json_node<>* n = p_values.front();
+		p_values.pop_front();
+		return n;
+	}
+	bool error() const { return p_parser.error(); }
+	size_t error_offset() const { return p_parser.error_offset(); }
+	json_error error_code() const { return p_parser.error_code(); }
+	void set_max_depth(const size_t depth) { p_parser.set_max_depth(depth); }
+	void reset() {
+		p_parser.reset();
+		p_handler.clear();
+		for (json_node<>* n : p_values) delete n;
+		p_values.clear();
+	}
+};
 
-inline json_node<>* json_parse(const string& json) {
+inline json_node<>* json_parse(const string& json, json_key_table* keys = nullptr) {
+	_JSON_STAT_SCOPE("parse");
 	//utf8 BOM判定を省略
-	const unsigned char* bom = (unsigned char*)json.c_str();
-	size_t pos = (json.size() >= 3 && bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF) ? 3 : 0;
+	size_t pos = _json_skip_bom(json.data(), json.size());
+	string e_temp;
+	json_node<>* n = _json_parse_type(json, pos, e_temp, nullptr, keys);
+	_JSON_STAT_BYTES(pos);
+	return n;
+}
+
+//読み込みの結果(失敗した場合はnodeがnullptrで、エラーの種類と位置を保持)
+struct json_parse_result {
+	json_node<>* node; //読み込んだノード(所有権は呼び出し側)
+	json_error error;
+	size_t offset; //エラーのバイト位置
+	size_t line;   //エラーの行(1から)
+	size_t column; //エラーの列(1から、バイト単位)
+
+	json_parse_result() : node(nullptr), error(json_error_none), offset(0), line(0), column(0) {}
+	explicit operator bool() const { return error == json_error_none; }
+	const char* message() const { return json_error_message(error); }
+};
+
+//再帰しない読み込み(スタックと一時バッファは読み込みごとに再利用、深さ・サイズの上限を指定可能)
+class json_parser {
+	_json_parse_context p_ctx;
+	string p_temp;
+	size_t p_max_size;
+
+	json_parse_result result(const char* json, const size_t n, const json_error e, const size_t pos) {
+		//エラー位置の行と列(エラー時のみ計算)
+		json_parse_result r;
+		r.error = e;
+		r.offset = pos < n ? pos : n;
+		r.line = 1;
+		size_t line_start = 0;
+		for (const char* p = json; (p = (const char*)memchr(p, '\n', json + r.offset - p)) != nullptr; ++p) {
+			++r.line;
+			line_start = p - json + 1;
+		}
+		r.column = r.offset - line_start + 1;
+		return r;
+	}
+public:
+	json_parser(const size_t max_depth = json_default_max_depth, const size_t max_size = 0) : p_ctx(max_depth), p_max_size(max_size) {}
+	//深さの上限(コンテナの入れ子の数)
+	void set_max_depth(const size_t depth) { p_ctx.max_depth = depth; }
+	size_t max_depth() const { return p_ctx.max_depth; }
+	//入力サイズの上限(0は無制限)
+	void set_max_size(const size_t size) { p_max_size = size; }
+	size_t max_size() const { return p_max_size; }
+
+	//SAX形式の読み込み(値の後に空白以外があればエラー)
+	template <class H>
+	json_parse_result sax_parse(const char* json, const size_t n, H& handler) {
+		if (p_max_size != 0 && n > p_max_size) return result(json, n, json_error_size, p_max_size);
+		size_t pos = _json_skip_bom(json, n);
+		if (!_json_sax_parse_iter(json, n, pos, p_temp, p_ctx, handler)) return result(json, n, p_ctx.error, p_ctx.error_pos);
+		pos = _json_skip_ws(json, pos, n);
+		if (pos < n) return result(json, n, json_error_trailing, pos);
+		return json_parse_result();
+	}
+	template <class H>
+	json_parse_result sax_parse(const string& json, H& handler) { return sax_parse(json.data(), json.size(), handler); }
+	json_parse_result parse(const char* json, const size_t n, json_key_table* keys = nullptr) {
+		_JSON_STAT_SCOPE("parse");
+		_JSON_STAT_BYTES(n);
+		_json_dom_handler h(nullptr, nullptr, keys);
+		json_parse_result r = sax_parse(json, n, h);
+		if (r) r.node = h.release();
+		return r;
+	}
+	json_parse_result parse(const string& json, json_key_table* keys = nullptr) { return parse(json.data(), json.size(), keys); }
+	//スタックの確保済みメモリを解放
+	void shrink() { vector<char>().swap(p_ctx.stack); string().swap(p_temp); }
+};
+
+//読み込み専用でメモリマップしたファイル(POSIX以外は読み込んだバッファ)
+class _json_file_map {
+	const char* m_data;
+	size_t m_size;
+#ifndef _JSON_POSIX
+	string m_buf;
+#endif
+public:
+	_json_file_map() : m_data(nullptr), m_size(0) {}
+	~_json_file_map() { close(); }
+	_json_file_map(const _json_file_map&) = delete;
+	_json_file_map& operator=(const _json_file_map&) = delete;
+
+	bool open(const string& path) {
+		close();
+#ifdef _JSON_POSIX
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+		struct stat st;
+		if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+		m_size = (size_t)st.st_size;
+		if (m_size == 0) { ::close(fd); m_data = ""; return true; }
+		void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (p == MAP_FAILED) { m_size = 0; return false; }
+		madvise(p, m_size, MADV_SEQUENTIAL);
+		m_data = (const char*)p;
+#else
+		ifstream f(path.c_str(), ios::binary);
+		if (!f) return false;
+		m_buf.assign(istreambuf_iterator<char>(f), istreambuf_iterator<char>());
+		m_data = m_buf.data();
+		m_size = m_buf.size();
+#endif
+		return true;
+	}
+	void close() {
+#ifdef _JSON_POSIX
+		if (m_data != nullptr && m_size != 0) munmap((void*)m_data, m_size);
+#else
+		m_buf.clear();
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
+	const char* data() const { return m_data; }
+	size_t size() const { return m_size; }
+};
+
+//ファイルをメモリマップして読み込み(文字列はコピーするため、戻り値はファイルと無関係に使用できる)
+inline json_node<>* json_parse_file(const string& path, json_key_table* keys = nullptr) {
+	_json_file_map m;
+	if (!m.open(path)) return nullptr;
+	size_t pos = _json_skip_bom(m.data(), m.size());
 	string e_temp;
-	return _json_parse_type(json, pos, e_temp);
+	return _json_parse_type(m.data(), m.size(), pos, e_temp, nullptr, keys);
 }
+
+//アリーナでノードを一括管理するドキュメント
+class json_document {
+	_json_arena d_arena;
+	json_node<>* d_root;
+	_json_file_map d_map;
+	json_key_table* d_keys;
+	string d_text; //遅延読み込みの入力
+
+	json_node<>* lazy_root(const char* p, const size_t n) {
+		size_t pos = _json_skip_bom(p, n);
+		string e_temp;
+		json_node<>* root = _json_lazy_value(p, n, pos, e_temp, &d_arena);
+		if (root != nullptr && _json_skip_ws(p, pos, n) != n) { delete root; root = nullptr; }
+		return root;
+	}
+public:
+	json_document(const size_t chunk = 64 * 1024) : d_arena(chunk), d_root(nullptr), d_keys(nullptr) {}
+	~json_document() { clear(); }
+	json_document(const json_document&) = delete;
+	json_document& operator=(const json_document&) = delete;
+
+	json_node<>* parse(const string& json) {
+		//既存のノードを破棄してから読み込み
+		clear();
+		size_t pos = _json_skip_bom(json.data(), json.size());
+		string e_temp;
+		d_root = _json_parse_type(json, pos, e_temp, &d_arena, d_keys);
+		return d_root;
+	}
+	json_node<>* parse_lazy(const string& json) { return parse_lazy(string(json)); }
+	json_node<>* parse_lazy(string&& json) {
+		//入力を保持し、コンテナは参照した時に直下の要素だけを読み込む
+		clear();
+		d_text = move(json);
+		return d_root = lazy_root(d_text.data(), d_text.size());
+	}
+	json_node<>* parse_file_lazy(const string& path) {
+		clear();
+		if (!d_map.open(path)) return nullptr;
+		return d_root = lazy_root(d_map.data(), d_map.size());
+	}
+	json_node<>* parse_file(const string& path) {
+		//ファイルをメモリマップし、文字列の値とキーはマップした領域を参照する(マップはドキュメントの破棄まで保持)
+		clear();
+		if (!d_map.open(path)) return nullptr;
+		size_t pos = _json_skip_bom(d_map.data(), d_map.size());
+		string e_temp;
+		_json_view_handler h(&d_arena, d_keys);
+		if (_json_sax_parse_type(d_map.data(), d_map.size(), pos, e_temp, h)) d_root = h.release();
+		return d_root;
+	}
+	//読み込み時に使用するキーの共有表(nullptrは共有しない)
+	void set_keys(json_key_table* keys) { d_keys = keys; }
+	//アリーナ上にノードを作成(ドキュメントより長く使用しないこと)
+	template <class N, class... A> N* create(A&&... args) { return _json_new<N>(&d_arena, std::forward<A>(args)...); }
+	json_node<>* root() { return d_root; }
+	json_node<>* set_root(json_node<>* n) { if (d_root != nullptr && d_root != n) delete d_root; d_root = n; return n; }
+	void clear() {
+		//ノード・スロットのメモリはアリーナの破棄で一括解放
+		//ただしノードが持つvector・string・共有キーの参照を解放するため、デストラクタはすべてのノードで呼び出す(ノード数に比例)
+		if (d_root != nullptr) { delete d_root; d_root = nullptr; }
+		d_arena.release();
+		d_map.close();
+		string().swap(d_text);
+	}
+};
+
+//複数スレッドで読み込む場合のスレッドごとの作業領域
+struct _json_parse_worker {
+	string e_temp;
+	json_key_table keys;
+	_json_dom_handler handler;
+	_json_parse_context ctx;
+	_json_parse_worker(const bool intern, const size_t max_depth = json_default_max_depth) : keys(65536), handler(nullptr, nullptr, intern ? &keys : nullptr), ctx(max_depth) {}
+	json_node<>* parse(const char* p, const size_t n, size_t& pos) {
+		//値を1つ読み込む(失敗した場合はnullptr)
+		if (_json_sax_parse_iter(p, n, pos, e_temp, ctx, handler)) return handler.release();
+		handler.clear();
+		return nullptr;
+	}
+};
+
+//改行区切りのJSON(NDJSON / JSON Lines)を複数スレッドで読み込むパーサー
+//入力をブロックに分割して各スレッドで読み込み、結果は行の順にコールバックへ渡す
+//JSONの文字列中の改行は必ずエスケープされるため、生の改行は常にレコードの区切りとして扱える
+class json_ndjson_parser {
+public:
+	//行番号(0から)と読み込んだノード(所有権は呼び出し側に移る、失敗した行はnullptr)、falseを返すと中断
+	typedef function<bool(size_t line, json_node<>* n)> callback;
+private:
+	struct _block {
+		size_t begin, end;
+		size_t lines; //ブロック内の行数
+		vector<pair<size_t, json_node<>*>> out; //ブロック内の行番号とノード
+		bool done;
+	};
+	unsigned n_threads;
+	size_t n_block;
+	bool n_intern;
+	size_t n_errors;
+
+	static void parse_block(const char* p, _block& b, _json_parse_worker& w) {
+		size_t line = 0;
+		size_t pos = b.begin;
+		while (pos < b.end) {
+			const char* nl = (const char*)memchr(p + pos, '\n', b.end - pos);
+			size_t end = nl != nullptr ? (size_t)(nl - p) : b.end;
+			size_t i = _json_skip_ws(p, pos, end);
+			if (i < end) { //空行は読み飛ばす
+				json_node<>* n = w.parse(p, end, i);
+				if (n != nullptr && _json_skip_ws(p, i, end) != end) { delete n; n = nullptr; }
+				b.out.push_back(make_pair(line, n));
+			}
+			++line;
+			pos = end + 1;
+		}
+		b.lines = line;
+	}
+	void split(const char* p, const size_t n, vector<_block>& blocks) {
+		//ブロックの大きさごとに次の改行までを1ブロックとする
+		size_t pos = _json_skip_bom(p, n);
+		while (pos < n) {
+			size_t end = pos + n_block < n ? pos + n_block : n;
+			if (end < n) {
+				const char* nl = (const char*)memchr(p + end, '\n', n - end);
+				end = nl != nullptr ? (size_t)(nl - p) + 1 : n;
+			}
+			_block b;
+			b.begin = pos;
+			b.end = end;
+			b.lines = 0;
+			b.done = false;
+			blocks.push_back(move(b));
+			pos = end;
+		}
+	}
+	bool deliver(_block& b, size_t& base, callback& cb, bool& ok) {
+		for (auto& r : b.out) {
+			if (r.second == nullptr) ++n_errors;
+			if (ok && !cb(base + r.first, r.second)) ok = false;
+			else if (!ok && r.second != nullptr) delete r.second;
+		}
+		base += b.lines;
+		vector<pair<size_t, json_node<>*>>().swap(b.out);
+		return ok;
+	}
+public:
+	json_ndjson_parser(const unsigned threads = 0, const size_t block = 1 << 20) : n_threads(threads), n_block(block > 0 ? block : 1), n_intern(true), n_errors(0) {
+		if (n_threads == 0) n_threads = thread::hardware_concurrency();
+		if (n_threads == 0) n_threads = 1;
+	}
+	//スレッドごとのキーの共有表を使用する(既定は使用する)
+	void set_intern_keys(const bool intern) { n_intern = intern; }
+	//直前の読み込みで失敗した行数
+	size_t errors() const { return n_errors; }
+
+	bool parse(const char* p, const size_t n, callback cb) {
+		n_errors = 0;
+		vector<_block> blocks;
+		split(p, n, blocks);
+		size_t base = 0;
+		bool ok = true;
+		unsigned threads = (unsigned)min<size_t>(n_threads, blocks.size());
+		if (threads <= 1) {
+			_json_parse_worker w(n_intern);
+			for (auto& b : blocks) {
+				parse_block(p, b, w);
+				if (!deliver(b, base, cb, ok)) break;
+			}
+			return ok;
+		}
+		//先読みするブロック数を制限してメモリ使用量を抑える
+		size_t window = (size_t)threads * 4;
+		size_t next = 0, delivered = 0;
+		bool stop = false;
+		mutex m;
+		condition_variable cv_work, cv_done;
+		vector<thread> pool;
+		for (unsigned t = 0; t < threads; ++t) {
+			pool.emplace_back([&]() {
+				_json_parse_worker w(n_intern);
+				unique_lock<mutex> lk(m);
+				for (;;) {
+					cv_work.wait(lk, [&]() { return stop || next >= blocks.size() || next < delivered + window; });
+					if (stop || next >= blocks.size()) return;
+					_block& b = blocks[next++];
+					lk.unlock();
+					parse_block(p, b, w);
+					lk.lock();
+					b.done = true;
+					cv_done.notify_all();
+				}
+			});
+		}
+		for (size_t i = 0; i < blocks.size(); ++i) {
+			{
+				unique_lock<mutex> lk(m);
+				cv_done.wait(lk, [&]() { return blocks[i].done; });
+			}
+			if (!deliver(blocks[i], base, cb, ok)) {
+				lock_guard<mutex> lk(m);
+				stop = true;
+				cv_work.notify_all();
+				break;
+			}
+			lock_guard<mutex> lk(m);
+			delivered = i + 1;
+			cv_work.notify_all();
+		}
+		for (thread& t : pool) t.join();
+		//中断した場合は読み込み済みのノードを破棄
+		for (auto& b : blocks) for (auto& r : b.out) if (r.second != nullptr) delete r.second;
+		return ok;
+	}
+	bool parse(const string& json, callback cb) { return parse(json.data(), json.size(), move(cb)); }
+	bool parse_file(const string& path, callback cb) {
+		_json_file_map m;
+		if (!m.open(path)) return false;
+		return parse(m.data(), m.size(), move(cb));
+	}
+};
+
+//改行区切りのJSONを読み込み、行の順に返す(空行は除く、失敗した行はnullptr)
+inline vector<json_node<>*> json_parse_ndjson(const string& json, const unsigned threads = 0) {
+	vector<json_node<>*> out;
+	json_ndjson_parser parser(threads);
+	parser.parse(json, [&out](size_t, json_node<>* n) { out.push_back(n); return true; });
+	return out;
+}
+
+//トップレベルの配列・オブジェクトの要素の区切り(深さ1の,)を検索
+//区切りの間隔がおよそstep以上になるように選び、終端の括弧の位置を返す(失敗した場合はnpos)
+inline size_t _json_split_top_level(const char* p, const size_t n, const size_t open, const size_t step, vector<size_t>& cuts) {
+	_json_stage1 s(json_simd_level());
+	size_t depth = 0;
+	size_t target = open + step;
+	for (size_t base = open & ~(size_t)63; base < n; base += 64) {
+		s.next(p, base, n);
+		uint64_t bits = s.b.op & ~s.in_string;
+		if (base < open) bits &= ~0ULL << (open - base);
+		while (bits != 0) {
+			size_t i = base + _json_ctz64(bits);
+			bits &= bits - 1;
+			if (i >= n) break;
+			char c = p[i];
+			if (c == '{' || c == '[') ++depth;
+			else if (c == '}' || c == ']') {
+				if (depth == 0 || --depth == 0) return depth == 0 && s.string_carry == 0 ? i : string::npos;
+			} else if (c == ',' && depth == 1 && i >= target) {
+				cuts.push_back(i);
+				target = i + step;
+			}
+		}
+	}
+	return string::npos;
+}
+
+//巨大なトップレベルの配列・オブジェクトを要素の範囲ごとに分割し、複数スレッドで読み込む
+//小さい入力やトップレベルがコンテナでない場合は通常の読み込みと同じ
+inline json_node<>* json_parse_parallel(const char* p, const size_t n, unsigned threads = 0, const size_t min_size = 1 << 20) {
+	if (threads == 0) threads = thread::hardware_concurrency();
+	size_t open = _json_skip_ws(p, _json_skip_bom(p, n), n);
+	if (threads <= 1 || n < min_size || open >= n || (p[open] != '[' && p[open] != '{')) {
+		string e_temp;
+		return _json_parse_type(p, n, open, e_temp);
+	}
+	const bool object = p[open] == '{';
+	//要素の区切りを検索(スレッド数の4倍程度に分割)
+	vector<size_t> cuts;
+	cuts.push_back(open);
+	size_t close = _json_split_top_level(p, n, open, n / (threads * 4) + 1, cuts);
+	if (close == string::npos || p[close] != (object ? '}' : ']') || _json_skip_ws(p, close + 1, n) != n) return nullptr;
+	cuts.push_back(close);
+
+	//各範囲(区切りの,の間)の要素を読み込む
+	struct _range {
+		vector<string> keys;
+		vector<json_node<>*> values;
+		bool ok;
+	};
+	vector<_range> ranges(cuts.size() - 1);
+	atomic<size_t> next(0);
+	atomic<bool> failed(false);
+	auto work = [&]() {
+		_json_parse_worker w(true, json_default_max_depth - 1); //トップレベルのコンテナの分を除いた深さ
+		for (size_t r; !failed.load(memory_order_relaxed) && (r = next.fetch_add(1)) < ranges.size(); ) {
+			_range& out = ranges[r];
+			size_t pos = cuts[r] + 1, end = cuts[r + 1];
+			out.ok = false;
+			for (;;) {
+				pos = _json_skip_ws(p, pos, end);
+				if (pos >= end) { out.ok = r + 1 == ranges.size() && out.values.empty() && r == 0; break; } //空のコンテナのみ許可
+				if (object) {
+					if (p[pos] != '\"') break;
+					++pos;
+					if (!_json_unescape(p, end, pos, w.e_temp)) break;
+					out.keys.push_back(w.e_temp);
+					pos = _json_skip_ws(p, pos, end);
+					if (pos >= end || p[pos] != ':') break;
+					++pos;
+				}
+				json_node<>* v = w.parse(p, end, pos);
+				if (v == nullptr) break;
+				out.values.push_back(v);
+				pos = _json_skip_ws(p, pos, end);
+				if (pos >= end) { out.ok = true; break; }
+				if (p[pos] != ',') break;
+				++pos;
+			}
+			if (!out.ok) failed.store(true);
+		}
+	};
+	vector<thread> pool;
+	unsigned workers = (unsigned)min<size_t>(threads, ranges.size());
+	for (unsigned t = 1; t < workers; ++t) pool.emplace_back(work);
+	work();
+	for (thread& t : pool) t.join();
+
+	//読み込んだ要素を順に連結
+	json_node<>* root = object ? (json_node<>*)new json_object<> : (json_node<>*)new json_array<>;
+	for (auto& r : ranges) {
+		if (failed.load()) {
+			for (json_node<>* v : r.values) delete v;
+			continue;
+		}
+		for (size_t i = 0; i < r.values.size(); ++i) {
+			if (object) root->set_object(r.keys[i], r.values[i]);
+			else root->add_array(r.values[i]);
+		}
+	}
+	if (failed.load()) { delete root; return nullptr; }
+	return root;
+}
+inline json_node<>* json_parse_parallel(const string& json, const unsigned threads = 0) { return json_parse_parallel(json.data(), json.size(), threads); }
+
+//並列出力のスレッドプール(print_parallelの呼び出しごとに1つ作成し、要素の多いコンテナごとに使い回す)
+//範囲は各スレッドの両端キューへ順に配り、自分のキューが空になったスレッドは他のキューの末尾から奪う
+class _json_print_pool {
+public:
+	struct job {
+		virtual void run(const size_t k, json_writer& w) = 0;
+	protected:
+		~job() {}
+	};
+private:
+	struct _queue {
+		mutex m;
+		deque<pair<job*, size_t> > q;
+	};
+	unsigned p_count;
+	string p_indentstr;
+	vector<thread> p_threads;
+	unique_ptr<_queue[]> p_queues;
+	mutex p_m;
+	condition_variable p_cv;
+	size_t p_pending; //キューに積まれて未取得の範囲の数
+	size_t p_next;    //次に配るキュー
+	bool p_stop;
+
+	bool take(const size_t self, pair<job*, size_t>& t) {
+		for (size_t i = 0; i < p_count; ++i) {
+			_queue& q = p_queues[(self + i) % p_count];
+			lock_guard<mutex> lk(q.m);
+			if (q.q.empty()) continue;
+			if (i == 0) { t = q.q.front(); q.q.pop_front(); }
+			else { t = q.q.back(); q.q.pop_back(); }
+			return true;
+		}
+		return false;
+	}
+	void work(const size_t self) {
+		json_writer w(nullptr, p_indentstr);
+		for (;;) {
+			{
+				//範囲を1つ予約してから取り出す(予約した数だけキューに残っている)
+				unique_lock<mutex> lk(p_m);
+				p_cv.wait(lk, [&]() { return p_stop || p_pending > 0; });
+				if (p_pending == 0) return;
+				--p_pending;
+			}
+			pair<job*, size_t> t;
+			while (!take(self, t)) this_thread::yield();
+			t.first->run(t.second, w);
+		}
+	}
+public:
+	_json_print_pool(const unsigned threads, const string& indentstr) : p_count(threads), p_indentstr(indentstr), p_pending(0), p_next(0), p_stop(false) {}
+	~_json_print_pool() {
+		{
+			lock_guard<mutex> lk(p_m);
+			p_stop = true;
+		}
+		p_cv.notify_all();
+		for (thread& t : p_threads) t.join();
+	}
+	_json_print_pool(const _json_print_pool&) = delete;
+	_json_print_pool& operator=(const _json_print_pool&) = delete;
+
+	unsigned size() const { return p_count; }
+	void push(job* j, const size_t k) {
+		//最初の範囲でスレッドを起動
+		if (p_threads.empty()) {
+			p_queues.reset(new _queue[p_count]);
+			for (unsigned i = 0; i < p_count; ++i) p_threads.emplace_back(&_json_print_pool::work, this, (size_t)i);
+		}
+		_queue& q = p_queues[p_next];
+		p_next = (p_next + 1) % p_count;
+		{
+			lock_guard<mutex> lk(q.m);
+			q.q.push_back(make_pair(j, k));
+		}
+		{
+			lock_guard<mutex> lk(p_m);
+			++p_pending;
+		}
+		p_cv.notify_one();
+	}
+};
+
+//要素の多いコンテナを見つけるまで木をたどり、そのコンテナの要素を範囲ごとに各スレッドのバッファへ出力して順に連結
+template <typename T>
+void _json_print_parallel(json_node<T>* n, json_writer& w, const int indent, _json_print_pool& pool) {
+	const size_t threshold = 256; //並列化する要素数
+	json_type t = n->type();
+	if (t != Object && t != Array) { n->_print(w, indent); return; }
+	const size_t size = n->size();
+	const int child_indent = indent > 0 ? indent+1 : 0;
+	bool first = true;
+	w.put(t == Object ? '{' : '[');
+	if (size < threshold) {
+		//要素が少ない場合は子孫を探す
+		for (size_t i = 0; i < size; ++i) {
+			json_node<T>* c = n->_child(i);
+			if (c == nullptr) continue;
+			if (!first) w.put(',');
+			first = false;
+			if (indent > 0) w.newline(indent);
+			const _json_key* key = n->_child_key(i);
+			if (key != nullptr) {
+				w.string_value(key->data, key->len);
+				if (indent > 0) w.append(" : ", 3);
+				else w.put(':');
+			}
+			_json_print_parallel(c, w, child_indent, pool);
+			w.check();
+		}
+	} else {
+		//範囲ごとに先頭の区切りを除いて出力し、連結時に区切りを補う
+		struct _chunk {
+			string out;
+			bool empty;
+			bool done;
+		};
+		struct _job : _json_print_pool::job {
+			json_node<T>* n;
+			int indent;
+			size_t size;
+			vector<_chunk> chunks;
+			mutex m;
+			condition_variable cv;
+			void run(const size_t k, json_writer& cw) {
+				bool cfirst = true;
+				for (size_t i = size * k / chunks.size(), e = size * (k + 1) / chunks.size(); i < e; ++i) {
+					json_node<T>* c = n->_child(i);
+					if (c != nullptr) _json_print_member(cw, indent, n->_child_key(i), c, cfirst);
+				}
+				string out = cw.take();
+				lock_guard<mutex> lk(m);
+				chunks[k].out.swap(out);
+				chunks[k].empty = cfirst;
+				chunks[k].done = true;
+				cv.notify_one();
+			}
+		} job;
+		n->_child(0); //各スレッドが参照する前に削除済みの要素を詰める
+		job.n = n;
+		job.indent = indent;
+		job.size = size;
+		const size_t count = min<size_t>(size, (size_t)pool.size() * 8), window = (size_t)pool.size() * 2;
+		job.chunks.resize(count);
+		for (auto& c : job.chunks) c.done = false;
+		//出力済みの範囲から一定数先までを配る(未連結のバッファを制限)
+		size_t pushed = 0;
+		for (; pushed < count && pushed < window; ++pushed) pool.push(&job, pushed);
+		for (size_t k = 0; k < count; ++k) {
+			string out;
+			bool empty;
+			{
+				unique_lock<mutex> lk(job.m);
+				job.cv.wait(lk, [&]() { return job.chunks[k].done; });
+				out.swap(job.chunks[k].out);
+				empty = job.chunks[k].empty;
+			}
+			if (pushed < count) pool.push(&job, pushed++);
+			if (empty) continue;
+			if (!first) w.put(',');
+			first = false;
+			w.write_through(out);
+		}
+	}
+	if (indent > 0 && !first) w.newline(indent-1);
+	w.put(t == Object ? '}' : ']');
+}
+template <typename T>
+void _json_print_parallel(json_node<T>* n, json_writer& w, const int indent, unsigned threads) {
+	if (threads == 0) threads = thread::hardware_concurrency();
+	if (threads <= 1) { n->_print(w, indent); return; }
+	_json_print_pool pool(threads, w.indentstr());
+	_json_print_parallel(n, w, indent, pool);
+}
+
+//値を1つ読み飛ばす(コンテナは括弧と文字列の範囲の判定のみ)
+inline bool _json_skip_value(const char* json, const size_t n, size_t& pos, const size_t max_depth = json_default_max_depth) {
+	pos = _json_skip_ws(json, pos, n);
+	if (pos >= n) return false;
+	char c = json[pos];
+	if (c == '{' || c == '[') return _json_skip_container(json, n, pos, max_depth);
+	if (c == '\"') {
+		bool escaped;
+		++pos;
+		return _json_skip_string(json, n, pos, escaped);
+	}
+	size_t begin = pos;
+	while (pos < n && json[pos] != ',' && json[pos] != '}' && json[pos] != ']' && json[pos] != ' ' && json[pos] != '\t' && json[pos] != '\n' && json[pos] != '\r') ++pos;
+	return pos > begin;
+}
+
+//JSON Pointer(RFC 6901)またはパス("a.b[3].c"、"items[*].id")を解析して再利用するクエリ
+//ノードの木と、木を作成せずに入力テキストから直接一致した値だけを取り出す方法の両方に使用できる
+class json_query {
+	struct _step {
+		char kind; //'k'キー, 'i'要素番号, 'p'キーまたは要素番号(JSON Pointer), '*'すべて
+		string name;
+		json_key key;
+		size_t index;
+	};
+	vector<_step> q_steps;
+	bool q_valid;
+
+	static bool to_index(const string& s, size_t& index) {
+		//先頭の0を許可しない10進数
+		if (s.empty() || s.size() > 19 || (s.size() > 1 && s[0] == '0')) return false;
+		index = 0;
+		for (char c : s) {
+			if (c < '0' || c > '9') return false;
+			index = index * 10 + (size_t)(c - '0');
+		}
+		return true;
+	}
+	void add(const char kind, const string& name, const size_t index = 0) {
+		_step st;
+		st.kind = kind;
+		st.name = name;
+		st.index = index;
+		if (kind == 'k' || kind == 'p') st.key = json_key(name);
+		if (kind == 'p' && !to_index(name, st.index)) st.index = string::npos;
+		q_steps.push_back(move(st));
+	}
+	bool match_key(const _step& st, const char* key, const size_t len) const {
+		if (st.kind == '*') return true;
+		if (st.kind == 'i') return false;
+		return st.name.size() == len && memcmp(st.name.data(), key, len) == 0;
+	}
+	bool match_index(const _step& st, const size_t num) const {
+		return st.kind == '*' || ((st.kind == 'i' || st.kind == 'p') && st.index == num);
+	}
+	template <class F>
+	bool run(json_node<>* n, const size_t i, F& f) const {
+		//falseを返すと探索を終了
+		if (n == nullptr) return true;
+		if (i == q_steps.size()) return f(n);
+		const _step& st = q_steps[i];
+		json_type t = n->type();
+		if (st.kind == '*') {
+			if (t != Object && t != Array) return true;
+			for (size_t c = 0, size = n->size(); c < size; ++c)
+				if (!run(n->_child(c), i + 1, f)) return false;
+			return true;
+		}
+		if (t == Object && st.kind != 'i') return run(n->get_object(st.key), i + 1, f);
+		if (t == Array && st.kind != 'k' && st.index != string::npos) return run(n->get_array(st.index), i + 1, f);
+		return true;
+	}
+	template <class F>
+	bool scan(const char* json, const size_t n, size_t& pos, const size_t i, string& e_temp, F& f, bool& ok) const {
+		//一致した値だけを作成し、それ以外は読み飛ばす(falseを返すと終了)
+		pos = _json_skip_ws(json, pos, n);
+		if (i == q_steps.size()) {
+			json_node<>* v = _json_parse_type(json, n, pos, e_temp);
+			if (v == nullptr) { ok = false; return false; }
+			return f(v);
+		}
+		if (pos >= n) { ok = false; return false; }
+		char c = json[pos];
+		if (c != '{' && c != '[') {
+			if (!_json_skip_value(json, n, pos)) { ok = false; return false; }
+			return true;
+		}
+		const bool object = c == '{';
+		const _step& st = q_steps[i];
+		pos = _json_skip_ws(json, pos + 1, n);
+		if (pos < n && json[pos] == (object ? '}' : ']')) { ++pos; return true; }
+		for (size_t num = 0; ; ++num) {
+			bool hit;
+			if (object) {
+				if (pos >= n || json[pos] != '\"') { ok = false; return false; }
+				size_t begin = ++pos;
+				bool escaped;
+				if (!_json_skip_string(json, n, pos, escaped)) { ok = false; return false; }
+				if (!escaped) hit = match_key(st, json + begin, pos - begin - 1);
+				else {
+					size_t k = begin;
+					if (!_json_unescape(json, n, k, e_temp)) { ok = false; return false; }
+					hit = match_key(st, e_temp.data(), e_temp.size());
+				}
+				pos = _json_skip_ws(json, pos, n);
+				if (pos >= n || json[pos] != ':') { ok = false; return false; }
+				++pos;
+			} else hit = match_index(st, num);
+			if (hit) {
+				if (!scan(json, n, pos, i + 1, e_temp, f, ok)) return false;
+			} else if (!_json_skip_value(json, n, pos)) { ok = false; return false; }
+			pos = _json_skip_ws(json, pos, n);
+			if (pos >= n) { ok = false; return false; }
+			if (json[pos] == (object ? '}' : ']')) { ++pos; return true; }
+			if (json[pos] != ',') { ok = false; return false; }
+			pos = _json_skip_ws(json, pos + 1, n);
+		}
+	}
+public:
+	json_query() : q_valid(false) {}
+	//JSON Pointer("/a/b/0"、空文字列は全体、~0は~、~1は/)
+	static json_query pointer(const string& ptr) {
+		json_query q;
+		q.q_valid = ptr.empty() || ptr[0] == '/';
+		for (size_t pos = 1; q.q_valid && pos <= ptr.size(); ) {
+			size_t end = ptr.find('/', pos);
+			if (end == string::npos) end = ptr.size();
+			string token;
+			for (size_t i = pos; i < end; ++i) {
+				if (ptr[i] != '~') token += ptr[i];
+				else if (i + 1 < end && (ptr[i+1] == '0' || ptr[i+1] == '1')) token += ptr[++i] == '0' ? '~' : '/';
+				else q.q_valid = false;
+			}
+			q.add('p', token);
+			pos = end + 1;
+		}
+		if (!q.q_valid) q.q_steps.clear();
+		return q;
+	}
+	//パス("a.b[3].c"、"$.items[*].id"、"a.*"、"[\"key.with.dot\"]")
+	static json_query path(const string& expr) {
+		json_query q;
+		q.q_valid = true;
+		size_t pos = 0, n = expr.size();
+		if (pos < n && expr[pos] == '$') ++pos;
+		while (q.q_valid && pos < n) {
+			if (expr[pos] == '[') {
+				size_t end;
+				if (pos + 1 < n && (expr[pos+1] == '\"' || expr[pos+1] == '\'')) {
+					end = expr.find(expr[pos+1], pos + 2);
+					if (end == string::npos || end + 1 >= n || expr[end+1] != ']') { q.q_valid = false; break; }
+					q.add('k', expr.substr(pos + 2, end - pos - 2));
+					pos = end + 2;
+					continue;
+				}
+				end = expr.find(']', pos);
+				if (end == string::npos) { q.q_valid = false; break; }
+				string token = expr.substr(pos + 1, end - pos - 1);
+				size_t index;
+				if (token == "*") q.add('*', "");
+				else if (to_index(token, index)) q.add('i', "", index);
+				else q.q_valid = false;
+				pos = end + 1;
+			} else {
+				if (expr[pos] == '.') ++pos;
+				size_t end = pos;
+				while (end < n && expr[end] != '.' && expr[end] != '[') ++end;
+				if (end == pos) { q.q_valid = false; break; }
+				string token = expr.substr(pos, end - pos);
+				if (token == "*") q.add('*', "");
+				else q.add('k', token);
+				pos = end;
+			}
+		}
+		if (!q.q_valid) q.q_steps.clear();
+		return q;
+	}
+	bool valid() const { return q_valid; }
+	size_t depth() const { return q_steps.size(); }
+
+	//最初に一致したノード(存在しない場合はnullptr)
+	json_node<>* find(json_node<>* root) const {
+		json_node<>* out = nullptr;
+		if (!q_valid) return nullptr;
+		auto f = [&out](json_node<>* n) { out = n; return false; };
+		run(root, 0, f);
+		return out;
+	}
+	//一致したすべてのノード(文書の順)
+	size_t find_all(json_node<>* root, vector<json_node<>*>& out) const {
+		size_t before = out.size();
+		if (!q_valid) return 0;
+		auto f = [&out](json_node<>* n) { out.push_back(n); return true; };
+		run(root, 0, f);
+		return out.size() - before;
+	}
+	//入力テキストから一致した値だけを作成してコールバックへ渡す(所有権は呼び出し側に移る、falseを返すと中断)
+	//一致しない部分は括弧と文字列の範囲の判定だけで読み飛ばすため、文法エラーを検出しない場合がある
+	bool extract(const char* json, const size_t n, const function<bool(json_node<>*)>& cb) const {
+		if (!q_valid) return false;
+		size_t pos = _json_skip_bom(json, n);
+		string e_temp;
+		bool ok = true;
+		scan(json, n, pos, 0, e_temp, cb, ok);
+		return ok;
+	}
+	bool extract(const string& json, const function<bool(json_node<>*)>& cb) const { return extract(json.data(), json.size(), cb); }
+	//最初に一致した値(存在しない場合はnullptr)
+	json_node<>* extract_first(const string& json) const {
+		json_node<>* out = nullptr;
+		extract(json, [&out](json_node<>* n) { out = n; return false; });
+		return out;
+	}
+};
+
+//構造体と直接変換するための定義(JSON_BIND(型, メンバ...)で指定、最大32メンバ)
+//メンバはbool、整数、浮動小数点数、string、vector(vector<bool>を含む)、JSON_BINDで定義した構造体に対応
+//入れ子の深さはjson_default_max_depthまで(再帰する構造体も読み込みで深さを制限)
+//キーのハッシュ値はコンパイル時に計算し、初回使用時に衝突しない表の大きさを決める(完全ハッシュ)
+constexpr uint32_t _json_fnv1a(const char* s, const uint32_t h = 2166136261u) { return *s ? _json_fnv1a(s + 1, (h ^ (uint32_t)(unsigned char)*s) * 16777619u) : h; }
+inline uint32_t _json_fnv1a(const char* p, const size_t n) {
+	uint32_t h = 2166136261u;
+	for (size_t i = 0; i < n; ++i) h = (h ^ (uint32_t)(unsigned char)p[i]) * 16777619u;
+	return h;
+}
+
+template <class T> struct json_binding;
+
+template <class T>
+struct _json_bind_field {
+	const char* name;
+	size_t len;
+	uint32_t hash;
+	bool (*parse)(T& obj, const char* json, const size_t n, size_t& pos, string& e_temp, const size_t depth);
+	void (*print)(const T& obj, json_writer& w, const int indent);
+};
+
+inline bool _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, bool& out, const size_t depth);
+inline bool _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, string& out, const size_t depth);
+template <class U> typename enable_if<is_arithmetic<U>::value, bool>::type _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, U& out, const size_t depth);
+template <class U> bool _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, vector<U>& out, const size_t depth);
+inline bool _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, vector<bool>& out, const size_t depth);
+template <class U> typename enable_if<is_class<U>::value, bool>::type _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, U& out, const size_t depth);
+inline void _json_bind_write(json_writer& w, const bool v, const int indent);
+inline void _json_bind_write(json_writer& w, const string& v, const int indent);
+template <class U> typename enable_if<is_arithmetic<U>::value>::type _json_bind_write(json_writer& w, const U v, const int indent);
+template <class U> void _json_bind_write(json_writer& w, const vector<U>& v, const int indent);
+template <class U> typename enable_if<is_class<U>::value>::type _json_bind_write(json_writer& w, const U& v, const int indent);
+
+template <class T, class M, M T::*P>
+bool _json_bind_parse_field(T& obj, const char* json, const size_t n, size_t& pos, string& e_temp, const size_t depth) { return _json_bind_value(json, n, pos, e_temp, obj.*P, depth); }
+template <class T, class M, M T::*P>
+void _json_bind_print_field(const T& obj, json_writer& w, const int indent) { _json_bind_write(w, obj.*P, indent); }
+
+//キーからメンバを検索する表(初回使用時に作成)
+template <class T>
+class _json_bind_table {
+	const _json_bind_field<T>* t_fields;
+	size_t t_count;
+	vector<uint8_t> t_slots; //メンバ番号+1(空の場合は線形探索)
+public:
+	_json_bind_table() {
+		t_fields = json_binding<T>::fields(t_count);
+		//すべてのハッシュ値の剰余が異なる大きさを探す
+		for (size_t size = t_count; size <= t_count * 64; ++size) {
+			t_slots.assign(size, 0);
+			size_t i = 0;
+			for (; i < t_count; ++i) {
+				uint8_t& slot = t_slots[t_fields[i].hash % size];
+				if (slot != 0) break;
+				slot = (uint8_t)(i + 1);
+			}
+			if (i == t_count) return;
+		}
+		t_slots.clear();
+	}
+	const _json_bind_field<T>* find(const char* key, const size_t len) const {
+		if (t_slots.empty()) {
+			for (size_t i = 0; i < t_count; ++i)
+				if (t_fields[i].len == len && memcmp(t_fields[i].name, key, len) == 0) return &t_fields[i];
+			return nullptr;
+		}
+		uint8_t slot = t_slots[_json_fnv1a(key, len) % t_slots.size()];
+		if (slot == 0) return nullptr;
+		const _json_bind_field<T>* f = &t_fields[slot - 1];
+		return f->len == len && memcmp(f->name, key, len) == 0 ? f : nullptr;
+	}
+	const _json_bind_field<T>* fields(size_t& count) const { count = t_count; return t_fields; }
+	static const _json_bind_table& get() {
+		static const _json_bind_table table;
+		return table;
+	}
+};
+
+inline bool _json_bind_null(const char* json, const size_t n, size_t& pos) {
+	//nullは既定値のまま読み飛ばす
+	if (pos + 4 <= n && memcmp(json + pos, "null", 4) == 0) { pos += 4; return true; }
+	return false;
+}
+inline bool _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, bool& out, const size_t depth) {
+	if (pos + 4 <= n && memcmp(json + pos, "true", 4) == 0) { pos += 4; out = true; return true; }
+	if (pos + 5 <= n && memcmp(json + pos, "false", 5) == 0) { pos += 5; out = false; return true; }
+	return false;
+}
+inline bool _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, string& out, const size_t depth) {
+	if (pos >= n || json[pos] != '\"') return false;
+	++pos;
+	return _json_unescape(json, n, pos, out);
+}
+//数値をメンバの型へ変換(型の範囲外、整数型に対する小数を含む値は失敗)
+template <class U>
+typename enable_if<is_floating_point<U>::value, bool>::type _json_bind_number(const _json_numval& v, U& out) {
+	const double d = v.to_double();
+	if (d > (double)numeric_limits<U>::max() || d < -(double)numeric_limits<U>::max()) return false;
+	out = (U)d;
+	return true;
+}
+template <class U>
+typename enable_if<is_integral<U>::value && is_signed<U>::value, bool>::type _json_bind_number(const _json_numval& v, U& out) {
+	int64_t i;
+	if (!v.to_int(i) || i < (int64_t)numeric_limits<U>::min() || i > (int64_t)numeric_limits<U>::max()) return false;
+	out = (U)i;
+	return true;
+}
+template <class U>
+typename enable_if<is_integral<U>::value && !is_signed<U>::value, bool>::type _json_bind_number(const _json_numval& v, U& out) {
+	uint64_t u;
+	if (!v.to_uint(u) || u > (uint64_t)numeric_limits<U>::max()) return false;
+	out = (U)u;
+	return true;
+}
+template <class U>
+typename enable_if<is_arithmetic<U>::value, bool>::type _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, U& out, const size_t depth) {
+	_json_numval v;
+	if (!_json_parse_number(json, n, pos, v)) return false;
+	return _json_bind_number(v, out);
+}
+template <class U>
+bool _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, vector<U>& out, const size_t depth) {
+	if (pos >= n || json[pos] != '[' || depth >= json_default_max_depth) return false;
+	out.clear();
+	pos = _json_skip_ws(json, pos + 1, n);
+	if (pos < n && json[pos] == ']') { ++pos; return true; }
+	for (;;) {
+		out.emplace_back();
+		if (!_json_bind_null(json, n, pos) && !_json_bind_value(json, n, pos, e_temp, out.back(), depth + 1)) return false;
+		pos = _json_skip_ws(json, pos, n);
+		if (pos >= n) return false;
+		if (json[pos] == ']') { ++pos; return true; }
+		if (json[pos] != ',') return false;
+		pos = _json_skip_ws(json, pos + 1, n);
+	}
+}
+inline bool _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, vector<bool>& out, const size_t depth) {
+	//要素は参照できないため読み込んでから追加
+	if (pos >= n || json[pos] != '[' || depth >= json_default_max_depth) return false;
+	out.clear();
+	pos = _json_skip_ws(json, pos + 1, n);
+	if (pos < n && json[pos] == ']') { ++pos; return true; }
+	for (;;) {
+		bool v = false;
+		if (!_json_bind_null(json, n, pos) && !_json_bind_value(json, n, pos, e_temp, v, depth + 1)) return false;
+		out.push_back(v);
+		pos = _json_skip_ws(json, pos, n);
+		if (pos >= n) return false;
+		if (json[pos] == ']') { ++pos; return true; }
+		if (json[pos] != ',') return false;
+		pos = _json_skip_ws(json, pos + 1, n);
+	}
+}
+template <class U>
+typename enable_if<is_class<U>::value, bool>::type _json_bind_value(const char* json, const size_t n, size_t& pos, string& e_temp, U& out, const size_t depth) {
+	//定義されていないキーは読み飛ばす
+	const _json_bind_table<U>& table = _json_bind_table<U>::get();
+	if (pos >= n || json[pos] != '{' || depth >= json_default_max_depth) return false;
+	pos = _json_skip_ws(json, pos + 1, n);
+	if (pos < n && json[pos] == '}') { ++pos; return true; }
+	for (;;) {
+		if (pos >= n || json[pos] != '\"') return false;
+		size_t begin = ++pos;
+		bool escaped;
+		if (!_json_skip_string(json, n, pos, escaped)) return false;
+		const _json_bind_field<U>* f;
+		if (!escaped) f = table.find(json + begin, pos - begin - 1);
+		else {
+			if (!_json_unescape(json, n, begin, e_temp)) return false;
+			f = table.find(e_temp.data(), e_temp.size());
+		}
+		pos = _json_skip_ws(json, pos, n);
+		if (pos >= n || json[pos] != ':') return false;
+		pos = _json_skip_ws(json, pos + 1, n);
+		if (f == nullptr) {
+			if (!_json_skip_value(json, n, pos, json_default_max_depth - depth - 1)) return false; //このオブジェクトの分を除いた深さ
+		} else if (!_json_bind_null(json, n, pos) && !f->parse(out, json, n, pos, e_temp, depth + 1)) return false;
+		pos = _json_skip_ws(json, pos, n);
+		if (pos >= n) return false;
+		if (json[pos] == '}') { ++pos; return true; }
+		if (json[pos] != ',') return false;
+		pos = _json_skip_ws(json, pos + 1, n);
+	}
+}
+
+inline void _json_bind_write(json_writer& w, const bool v, const int indent) { if (v) w.append("true", 4); else w.append("false", 5); }
+inline void _json_bind_write(json_writer& w, const string& v, const int indent) { w.string_value(v); }
+template <class U>
+typename enable_if<is_arithmetic<U>::value>::type _json_bind_write(json_writer& w, const U v, const int indent) {
+	char buf[32];
+	char* end;
+	if (is_floating_point<U>::value) end = _json_dtoa((double)v, buf);
+	else if (is_signed<U>::value) end = _json_itoa((int64_t)v, buf);
+	else end = _json_utoa((uint64_t)v, buf);
+	w.append(buf, (size_t)(end - buf));
+}
+template <class U>
+void _json_bind_write(json_writer& w, const vector<U>& v, const int indent) {
+	//出力はjson_arrayと同じ
+	w.put('[');
+	for (size_t i = 0; i < v.size(); ++i) {
+		if (i != 0) w.put(',');
+		if (indent > 0) w.newline(indent);
+		_json_bind_write(w, v[i], indent > 0 ? indent+1 : 0);
+		w.check();
+	}
+	if (indent > 0 && !v.empty()) w.newline(indent-1);
+	w.put(']');
+}
+template <class U>
+typename enable_if<is_class<U>::value>::type _json_bind_write(json_writer& w, const U& v, const int indent) {
+	//出力はjson_objectと同じ(定義したメンバの順)
+	size_t count;
+	const _json_bind_field<U>* f = _json_bind_table<U>::get().fields(count);
+	w.put('{');
+	for (size_t i = 0; i < count; ++i) {
+		if (i != 0) w.put(',');
+		if (indent > 0) w.newline(indent);
+		w.string_value(f[i].name, f[i].len);
+		if (indent > 0) w.append(" : ", 3);
+		else w.put(':');
+		f[i].print(v, w, indent > 0 ? indent+1 : 0);
+		w.check();
+	}
+	if (indent > 0 && count != 0) w.newline(indent-1);
+	w.put('}');
+}
+
+//テキストから構造体へ直接読み込む(ノードを作成しない)
+template <class T>
+bool json_parse_into(const char* json, const size_t n, T& out) {
+	size_t pos = _json_skip_ws(json, _json_skip_bom(json, n), n);
+	string e_temp;
+	return _json_bind_value(json, n, pos, e_temp, out, 0) && _json_skip_ws(json, pos, n) == n;
+}
+template <class T>
+bool json_parse_into(const string& json, T& out) { return json_parse_into(json.data(), json.size(), out); }
+template <class T>
+T json_parse_into(const string& json) {
+	//失敗した場合は既定値
+	T out = T();
+	if (!json_parse_into(json, out)) out = T();
+	return out;
+}
+//構造体から直接書き出す
+template <class T>
+string json_print_from(const T& v, const int indent = 1, const string& indentstr = "\t") {
+	json_writer w(nullptr, indentstr);
+	_json_bind_write(w, v, indent);
+	return w.take();
+}
+template <class T>
+bool json_print_from(json_sink& sink, const T& v, const int indent = 1, const string& indentstr = "\t") {
+	json_writer w(&sink, indentstr);
+	_json_bind_write(w, v, indent);
+	return w.flush();
+}
+
+#define _JSON_EXPAND(x) x
+#define _JSON_CAT(a, b) _JSON_CAT_(a, b)
+#define _JSON_CAT_(a, b) a##b
+#define _JSON_NARG(...) _JSON_EXPAND(_JSON_NARG_(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define _JSON_NARG_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+#define _JSON_FE_1(m, T, x) m(T, x)
+#define _JSON_FE_2(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_1(m, T, __VA_ARGS__))
+#define _JSON_FE_3(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_2(m, T, __VA_ARGS__))
+#define _JSON_FE_4(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_3(m, T, __VA_ARGS__))
+#define _JSON_FE_5(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_4(m, T, __VA_ARGS__))
+#define _JSON_FE_6(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_5(m, T, __VA_ARGS__))
+#define _JSON_FE_7(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_6(m, T, __VA_ARGS__))
+#define _JSON_FE_8(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_7(m, T, __VA_ARGS__))
+#define _JSON_FE_9(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_8(m, T, __VA_ARGS__))
+#define _JSON_FE_10(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_9(m, T, __VA_ARGS__))
+#define _JSON_FE_11(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_10(m, T, __VA_ARGS__))
+#define _JSON_FE_12(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_11(m, T, __VA_ARGS__))
+#define _JSON_FE_13(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_12(m, T, __VA_ARGS__))
+#define _JSON_FE_14(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_13(m, T, __VA_ARGS__))
+#define _JSON_FE_15(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_14(m, T, __VA_ARGS__))
+#define _JSON_FE_16(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_15(m, T, __VA_ARGS__))
+#define _JSON_FE_17(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_16(m, T, __VA_ARGS__))
+#define _JSON_FE_18(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_17(m, T, __VA_ARGS__))
+#define _JSON_FE_19(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_18(m, T, __VA_ARGS__))
+#define _JSON_FE_20(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_19(m, T, __VA_ARGS__))
+#define _JSON_FE_21(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_20(m, T, __VA_ARGS__))
+#define _JSON_FE_22(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_21(m, T, __VA_ARGS__))
+#define _JSON_FE_23(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_22(m, T, __VA_ARGS__))
+#define _JSON_FE_24(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_23(m, T, __VA_ARGS__))
+#define _JSON_FE_25(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_24(m, T, __VA_ARGS__))
+#define _JSON_FE_26(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_25(m, T, __VA_ARGS__))
+#define _JSON_FE_27(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_26(m, T, __VA_ARGS__))
+#define _JSON_FE_28(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_27(m, T, __VA_ARGS__))
+#define _JSON_FE_29(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_28(m, T, __VA_ARGS__))
+#define _JSON_FE_30(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_29(m, T, __VA_ARGS__))
+#define _JSON_FE_31(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_30(m, T, __VA_ARGS__))
+#define _JSON_FE_32(m, T, x, ...) m(T, x) _JSON_EXPAND(_JSON_FE_31(m, T, __VA_ARGS__))
+#define _JSON_FOR_EACH(m, T, ...) _JSON_EXPAND(_JSON_CAT(_JSON_FE_, _JSON_NARG(__VA_ARGS__))(m, T, __VA_ARGS__))
+#define _JSON_BIND_FIELD(T, m) { #m, sizeof(#m) - 1, _json_fnv1a(#m), &_json_bind_parse_field<T, decltype(T::m), &T::m>, &_json_bind_print_field<T, decltype(T::m), &T::m> },
+//グローバル名前空間で使用すること
+#define JSON_BIND(T, ...) \
+template <> struct json_binding<T> { \
+	static const _json_bind_field<T>* fields(size_t& count) { \
+		static const _json_bind_field<T> f[] = { _JSON_FOR_EACH(_JSON_BIND_FIELD, T, __VA_ARGS__) }; \
+		count = sizeof(f) / sizeof(f[0]); \
+		return f; \
+	} \
+};
+
+//参照カウントで共有する不変の値(コピーはO(1)で、変更時は共有されている部分のみ複製する)
+//変更は根から変更箇所までの経路だけを複製し、変更の無い部分木は以前の版と共有する
+//同じjson_valueの変数を複数のスレッドから同時に変更しないこと(コピーした値は各スレッドで自由に読み書きできる)
+class json_value {
+	struct rep {
+		atomic<uint32_t> refs;
+		json_type type;
+		bool b;
+		_json_numval num;
+		string str;
+		vector<json_key> keys;     //オブジェクトのキー
+		vector<json_value> items;  //オブジェクトの値・配列の要素
+		vector<uint32_t> index;    //キーの索引(要素番号+1、要素数がlinear_maxを超える場合のみ)
+
+		rep(const json_type t) : refs(1), type(t), b(false) {}
+		rep(const rep& o) : refs(1), type(o.type), b(o.b), num(o.num), str(o.str), keys(o.keys), items(o.items), index(o.index) {}
+	};
+	static const size_t linear_max = 8;
+	rep* v; //nullptrはnull
+
+	explicit json_value(rep* r) : v(r) {}
+	static void release(rep* r) { if (r != nullptr && r->refs.fetch_sub(1, memory_order_acq_rel) == 1) delete r; }
+	rep* unique() {
+		//共有されている場合は複製(子は参照を共有)
+		if (v->refs.load(memory_order_acquire) != 1) {
+			rep* c = new rep(*v);
+			release(v);
+			v = c;
+		}
+		return v;
+	}
+	void reset(rep* r) { release(v); v = r; }
+	static void index_insert(rep* r, const size_t num) {
+		size_t mask = r->index.size() - 1;
+		size_t i = r->keys[num].get()->hash & mask;
+		while (r->index[i] != 0) i = (i + 1) & mask;
+		r->index[i] = (uint32_t)(num + 1);
+	}
+	static void index_rebuild(rep* r) {
+		if (r->keys.size() <= linear_max) { r->index.clear(); return; }
+		size_t cap = 32;
+		while (cap < r->keys.size() * 2) cap <<= 1;
+		r->index.assign(cap, 0);
+		for (size_t i = 0; i < r->keys.size(); ++i) index_insert(r, i);
+	}
+	size_t find(const char* key, const size_t len, const uint32_t h) const {
+		//キーの位置(存在しない場合はnpos)
+		if (v == nullptr || v->type != Object) return string::npos;
+		if (v->index.empty()) {
+			for (size_t i = 0; i < v->keys.size(); ++i) {
+				const _json_key* k = v->keys[i].get();
+				if (k->hash == h && k->len == len && memcmp(k->data, key, len) == 0) return i;
+			}
+			return string::npos;
+		}
+		size_t mask = v->index.size() - 1;
+		for (size_t i = h & mask; v->index[i] != 0; i = (i + 1) & mask) {
+			const _json_key* k = v->keys[v->index[i] - 1].get();
+			if (k->hash == h && k->len == len && memcmp(k->data, key, len) == 0) return v->index[i] - 1;
+		}
+		return string::npos;
+	}
+	size_t find(const string& key) const { return find(key.data(), key.size(), _json_hash_key(key.data(), key.size())); }
+	static json_value leaf(const json_type t) { return json_value(new rep(t)); }
+	template <class N> static json_value from_node(N* n) {
+		//ノードから変換(アリーナ上のキーは複製)
+		switch (n->type()) {
+			case Object: {
+				json_value o = object();
+				for (size_t i = 0, size = n->size(); i < size; ++i) {
+					json_node<>* c = n->_child(i);
+					if (c == nullptr) continue;
+					const _json_key* k = n->_child_key(i);
+					o.v->keys.push_back(k->arena ? json_key(k->data, k->len) : json_key(const_cast<_json_key*>(k), true));
+					o.v->items.push_back(from_node(c));
+				}
+				index_rebuild(o.v);
+				return o;
+			}
+			case Array: {
+				json_value a = array();
+				a.v->items.reserve(n->size());
+				for (size_t i = 0, size = n->size(); i < size; ++i)
+					if (json_node<>* c = n->_child(i)) a.v->items.push_back(from_node(c));
+				return a;
+			}
+			case String: return json_value(n->get_string());
+			case Number: { json_value r = leaf(Number); r.v->num = n->get_numval(); return r; }
+			case Boolean: return json_value(n->get_bool());
+			default: return json_value();
+		}
+	}
+	friend class _json_value_handler;
+public:
+	json_value() : v(nullptr) {}
+	json_value(nullptr_t) : v(nullptr) {}
+	json_value(const bool b) : v(new rep(Boolean)) { v->b = b; }
+	json_value(const double d) : v(new rep(Number)) { v->num.kind = 'd'; v->num.d = d; }
+	template <typename I> json_value(const I i, typename enable_if<is_integral<I>::value && is_signed<I>::value, int>::type = 0) : v(new rep(Number)) { v->num.kind = 'i'; v->num.i = i; }
+	template <typename I> json_value(const I u, typename enable_if<is_integral<I>::value && !is_signed<I>::value, int>::type = 0) : v(new rep(Number)) {
+		if ((uint64_t)u <= (uint64_t)INT64_MAX) { v->num.kind = 'i'; v->num.i = (int64_t)u; }
+		else { v->num.kind = 'u'; v->num.u = u; }
+	}
+	json_value(const string& s) : v(new rep(String)) { v->str = s; }
+	json_value(string&& s) : v(new rep(String)) { v->str = std::move(s); }
+	json_value(const char* s) : v(new rep(String)) { v->str = s; }
+	//ノードの内容を複製して作成(nullptrはnull)
+	explicit json_value(json_node<>* n) : v(nullptr) { if (n != nullptr) *this = from_node(n); }
+	json_value(const json_value& o) : v(o.v) { if (v != nullptr) v->refs.fetch_add(1, memory_order_relaxed); }
+	json_value(json_value&& o) : v(o.v) { o.v = nullptr; }
+	~json_value() { release(v); }
+	json_value& operator=(json_value o) { swap(v, o.v); return *this; }
+	static json_value object() { return leaf(Object); }
+	static json_value array() { return leaf(Array); }
+
+	//読み込み(失敗した場合はfalse)
+	static inline bool parse(const char* json, const size_t n, json_value& out);
+	static bool parse(const string& json, json_value& out) { return parse(json.data(), json.size(), out); }
+
+	json_type type() const { return v != nullptr ? v->type : Null; }
+	//同じ内容を共有しているか(複製されていない部分木の判定)
+	bool shares(const json_value& o) const { return v == o.v; }
+	size_t use_count() const { return v != nullptr ? v->refs.load(memory_order_relaxed) : 0; }
+
+	string get_string() const {
+		switch (type()) {
+			case String: return v->str;
+			case Number: return v->num.to_string();
+			case Boolean: return v->b ? "true" : "false";
+			default: return "";
+		}
+	}
+	double get_number() const { return type() == Number ? v->num.to_double() : type() == Boolean ? (double)v->b : 0; }
+	int64_t get_int() const { return type() == Number ? v->num.clamp_int() : _json_clamp_int(get_number()); }
+	uint64_t get_uint() const { return type() == Number ? v->num.clamp_uint() : _json_clamp_uint(get_number()); }
+	bool get_bool() const { return type() == Boolean ? v->b : type() == Number && get_number() != 0; }
+	//型が一致する場合のみ取得(一致しない場合はfalse、値をコピー・変換しない)
+	bool try_get_string(json_string_view& out) const { if (type() != String) return false; out = json_string_view(v->str); return true; }
+	bool try_get_number(double& out) const { if (type() != Number) return false; out = v->num.to_double(); return true; }
+	bool try_get_int(int64_t& out) const { return type() == Number && v->num.to_int(out); }
+	bool try_get_uint(uint64_t& out) const { return type() == Number && v->num.to_uint(out); }
+	bool try_get_bool(bool& out) const { if (type() != Boolean) return false; out = v->b; return true; }
+	json_string_view get_string_view() const { return type() == String ? json_string_view(v->str) : json_string_view(); }
+	size_t size() const { return type() == Object || type() == Array ? v->items.size() : 0; }
+
+	//取得(存在しない場合はnullptr)
+	const json_value* get_object(const string& key) const {
+		size_t num = find(key);
+		return num != string::npos ? &v->items[num] : nullptr;
+	}
+	const json_value* get_object(const json_key& key) const {
+		size_t num = key.empty() ? string::npos : find(key.data(), key.size(), key.get()->hash);
+		return num != string::npos ? &v->items[num] : nullptr;
+	}
+	const json_value* get_array(const size_t num) const { return type() == Array && num < v->items.size() ? &v->items[num] : nullptr; }
+	//num番目の子(オブジェクトは追加順)
+	const json_value* child(const size_t num) const { return num < size() ? &v->items[num] : nullptr; }
+	const json_key* child_key(const size_t num) const { return type() == Object && num < v->keys.size() ? &v->keys[num] : nullptr; }
+	const json_value& operator[](const string& key) const { const json_value* r = get_object(key); return r != nullptr ? *r : null_value(); }
+	const json_value& operator[](const size_t num) const { const json_value* r = get_array(num); return r != nullptr ? *r : null_value(); }
+	static const json_value& null_value() { static const json_value n; return n; }
+
+	//変更用の取得(このノードと子を共有していれば複製、存在しない場合はnullptr)
+	json_value* edit_object(const string& key) {
+		size_t num = find(key);
+		return num != string::npos ? &unique()->items[num] : nullptr;
+	}
+	json_value* edit_array(const size_t num) { return type() == Array && num < v->items.size() ? &unique()->items[num] : nullptr; }
+
+	//変更(オブジェクト・配列以外に対して呼び出した場合は何もしない)
+	void set_object(const string& key, json_value n) {
+		if (type() != Object) return;
+		uint32_t h = _json_hash_key(key.data(), key.size());
+		size_t num = find(key.data(), key.size(), h);
+		rep* r = unique();
+		if (num != string::npos) { r->items[num] = move(n); return; }
+		r->keys.push_back(json_key(_json_key_new(key.data(), key.size(), h), false));
+		r->items.push_back(move(n));
+		if (r->keys.size() > linear_max) {
+			if (r->index.empty() || r->keys.size() * 2 > r->index.size()) index_rebuild(r);
+			else index_insert(r, r->keys.size() - 1);
+		}
+	}
+	void set_array(const size_t num, json_value n) {
+		//範囲外はnullで埋めて追加
+		if (type() != Array) return;
+		rep* r = unique();
+		if (num >= r->items.size()) r->items.resize(num + 1);
+		r->items[num] = move(n);
+	}
+	void add_array(json_value n) { if (type() == Array) unique()->items.push_back(move(n)); }
+	void delete_object(const string& key) {
+		size_t num = find(key);
+		if (num == string::npos) return;
+		rep* r = unique();
+		r->keys.erase(r->keys.begin() + num);
+		r->items.erase(r->items.begin() + num);
+		index_rebuild(r);
+	}
+	void delete_array(const size_t num) {
+		if (type() != Array || num >= v->items.size()) return;
+		rep* r = unique();
+		r->items.erase(r->items.begin() + num);
+	}
+	void reserve(const size_t n) {
+		if (type() != Object && type() != Array) return;
+		rep* r = unique();
+		r->items.reserve(n);
+		if (r->type == Object) r->keys.reserve(n);
+	}
+	//値の置き換え(以前の値を共有している版には影響しない)
+	void set_string(const string& s) { reset(new rep(String)); v->str = s; }
+	void set_string(string&& s) { reset(new rep(String)); v->str = std::move(s); }
+	void set_number(const double d) { *this = json_value(d); }
+	void set_int(const int64_t i) { *this = json_value(i); }
+	void set_uint(const uint64_t u) { *this = json_value(u); }
+	void set_bool(const bool b) { *this = json_value(b); }
+	void set_null() { reset(nullptr); }
+
+	//ノードに変換(所有権は呼び出し側)
+	json_node<>* to_node() const {
+		switch (type()) {
+			case Object: {
+				json_object<>* o = new json_object<>;
+				o->reserve(v->items.size());
+				for (size_t i = 0; i < v->items.size(); ++i) o->_set_key(v->keys[i].get(), v->items[i].to_node());
+				return o;
+			}
+			case Array: {
+				json_array<>* a = new json_array<>(v->items.size());
+				for (size_t i = 0; i < v->items.size(); ++i) a->set_array(i, v->items[i].to_node());
+				return a;
+			}
+			case String: return new json_string<>(v->str);
+			case Number: return new json_number<>(v->num);
+			case Boolean: return new json_boolean<>(v->b);
+			default: return new json_null<>();
+		}
+	}
+
+	void _print(json_writer& w, const int indent) const {
+		//json_nodeと同じ形式で出力
+		switch (type()) {
+			case Object: case Array: {
+				const bool obj = v->type == Object;
+				w.put(obj ? '{' : '[');
+				for (size_t i = 0; i < v->items.size(); ++i) {
+					if (i != 0) w.put(',');
+					if (indent > 0) w.newline(indent);
+					if (obj) {
+						w.string_value(v->keys[i].data(), v->keys[i].size());
+						if (indent > 0) w.append(" : ", 3);
+						else w.put(':');
+					}
+					v->items[i]._print(w, indent > 0 ? indent+1 : 0);
+					w.check();
+				}
+				if (indent > 0 && !v->items.empty()) w.newline(indent-1);
+				w.put(obj ? '}' : ']');
+				break;
+			}
+			case String: w.string_value(v->str); break;
+			case Number: { char buf[32]; w.append(buf, (size_t)(v->num.write(buf) - buf)); break; }
+			case Boolean: if (v->b) w.append("true", 4); else w.append("false", 5); break;
+			default: w.append("null", 4); break;
+		}
+	}
+	string print(const int indent = 1, const string& indentstr = "\t") const {
+		json_writer w(nullptr, indentstr);
+		_print(w, indent);
+		return w.take();
+	}
+	bool print_to(json_sink& sink, const int indent = 1, const string& indentstr = "\t") const {
+		json_writer w(&sink, indentstr);
+		_print(w, indent);
+		return w.flush();
+	}
+};
+
+//json_valueを作成するSAXハンドラ
+class _json_value_handler : public json_sax_handler<_json_value_handler> {
+	vector<json_value> h_stack;
+	vector<json_key> h_keys; //各オブジェクトの読み込み中のキー
+	json_value h_root;
+	bool h_done;
+
+	bool add(json_value n) {
+		if (h_stack.empty()) { h_root = move(n); h_done = true; return true; }
+		json_value::rep* r = h_stack.back().v;
+		if (r->type == Object) {
+			//重複したキーは後の値で置き換える(json_objectと同じ)
+			const _json_key* k = h_keys.back().get();
+			size_t num = h_stack.back().find(k->data, k->len, k->hash);
+			if (num != string::npos) { r->items[num] = move(n); return true; }
+			r->keys.push_back(move(h_keys.back()));
+			r->items.push_back(move(n));
+			if (r->keys.size() > json_value::linear_max) {
+				if (r->index.empty() || r->keys.size() * 2 > r->index.size()) json_value::index_rebuild(r);
+				else json_value::index_insert(r, r->keys.size() - 1);
+			}
+		} else r->items.push_back(move(n));
+		return true;
+	}
+	bool start(json_value n) {
+		if (n.type() == Object) h_keys.push_back(json_key());
+		h_stack.push_back(move(n));
+		return true;
+	}
+	bool end() {
+		json_value n = move(h_stack.back());
+		h_stack.pop_back();
+		if (n.type() == Object) h_keys.pop_back();
+		return add(move(n));
+	}
+public:
+	_json_value_handler() : h_done(false) {}
+	bool start_object() { return start(json_value::object()); }
+	bool start_array() { return start(json_value::array()); }
+	bool end_object() { return end(); }
+	bool end_array() { return end(); }
+	bool key(const std::string& k) { h_keys.back() = json_key(k); return true; }
+	bool string(const std::string& s) { return add(json_value(s)); }
+	bool number(const double d) { return add(json_value(d)); }
+	bool integer(const int64_t i) { return add(json_value(i)); }
+	bool uinteger(const uint64_t u) { return add(json_value(u)); }
+	bool boolean(const bool b) { return add(json_value(b)); }
+	bool null() { return add(json_value()); }
+	bool done() const { return h_done; }
+	json_value& root() { return h_root; }
+};
+inline bool json_value::parse(const char* json, const size_t n, json_value& out) {
+	_json_value_handler h;
+	size_t pos = _json_skip_bom(json, n);
+	string e_temp;
+	if (!_json_sax_parse_type(json, n, pos, e_temp, h) || !h.done()) return false;
+	out = move(h.root());
+	return true;
+}
+
+//読み取り専用の文書(作成後は変更されず、読み取りは内容を書き換えないため複数のスレッドからロックなしで読み取れる)
+//読み取りはconstの参照を返し、参照カウントも変更しない
+class json_frozen {
+	json_value f_root;
+public:
+	explicit json_frozen(json_value v) : f_root(move(v)) {}
+	const json_value& root() const { return f_root; }
+	json_type type() const { return f_root.type(); }
+	size_t size() const { return f_root.size(); }
+	const json_value* get_object(const string& key) const { return f_root.get_object(key); }
+	const json_value* get_object(const json_key& key) const { return f_root.get_object(key); }
+	const json_value* get_array(const size_t num) const { return f_root.get_array(num); }
+	const json_value& operator[](const string& key) const { return f_root[key]; }
+	const json_value& operator[](const size_t num) const { return f_root[num]; }
+	string print(const int indent = 1, const string& indentstr = "\t") const { return f_root.print(indent, indentstr); }
+	bool print_to(json_sink& sink, const int indent = 1, const string& indentstr = "\t") const { return f_root.print_to(sink, indent, indentstr); }
+	//変更用の値(O(1)で複製し、変更した部分のみ複製される)
+	json_value thaw() const { return f_root; }
+};
+//読み取り専用の文書を作成(ノードは複製するため、以降の変更は影響しない)
+inline shared_ptr<const json_frozen> json_freeze(json_value v) { return make_shared<const json_frozen>(move(v)); }
+inline shared_ptr<const json_frozen> json_freeze(json_node<>* n) { return n != nullptr ? json_freeze(json_value(n)) : nullptr; }
+//読み込んで読み取り専用の文書を作成(失敗した場合はnullptr)
+inline shared_ptr<const json_frozen> json_freeze_parse(const string& json) {
+	json_value v;
+	if (!json_value::parse(json, v)) return nullptr;
+	return json_freeze(move(v));
+}
+
+//読み取り専用の文書の公開・入れ替え(RCU方式)
+//書き込み側はpublishで新しい版に入れ替え、読み取り側はreaderで最新版を取得する
+//古い版は読み取り側が次の版を取得した時点で解放される
+template <class D = json_frozen>
+class json_publisher {
+	mutable mutex p_lock;
+	shared_ptr<const D> p_current;
+	atomic<uint64_t> p_version;
+
+	uint64_t load(shared_ptr<const D>& out) const {
+		lock_guard<mutex> lock(p_lock);
+		out = p_current;
+		return p_version.load(memory_order_relaxed);
+	}
+public:
+	explicit json_publisher(shared_ptr<const D> d = nullptr) : p_current(move(d)), p_version(1) {}
+	json_publisher(const json_publisher&) = delete;
+	json_publisher& operator=(const json_publisher&) = delete;
+
+	//新しい版を公開
+	void publish(shared_ptr<const D> d) { exchange(move(d)); }
+	//新しい版を公開して以前の版を返す
+	shared_ptr<const D> exchange(shared_ptr<const D> d) {
+		lock_guard<mutex> lock(p_lock);
+		swap(p_current, d);
+		p_version.fetch_add(1, memory_order_release);
+		return d;
+	}
+	//最新版(ロックを取得するため、頻繁に読み取る場合はreaderを使用)
+	shared_ptr<const D> load() const {
+		shared_ptr<const D> d;
+		load(d);
+		return d;
+	}
+	uint64_t version() const { return p_version.load(memory_order_acquire); }
+
+	//読み取り側(スレッドごとに作成)
+	//版が変わっていなければ保持している版を返すため、ロックも参照カウントの変更も行わない
+	class reader {
+		const json_publisher* r_pub;
+		shared_ptr<const D> r_doc;
+		uint64_t r_version;
+	public:
+		explicit reader(const json_publisher& p) : r_pub(&p), r_version(0) {}
+		const shared_ptr<const D>& current() {
+			if (r_pub->p_version.load(memory_order_acquire) != r_version) r_version = r_pub->load(r_doc);
+			return r_doc;
+		}
+		const D* operator->() { return current().get(); }
+		const D& operator*() { return *current(); }
+		//保持している版を解放(次のcurrentで再取得)
+		void release() { r_doc.reset(); r_version = 0; }
+	};
+};
+
+//バイナリ形式(CBOR, MessagePack)の共通処理
+static const int _json_binary_max_depth = 1024;
+
+inline void _json_put_be(string& out, const uint64_t v, const int bytes) {
+	//ビッグエンディアンで追加
+	char buf[8];
+	for (int i = 0; i < bytes; ++i) buf[i] = (char)(v >> (8 * (bytes - 1 - i)));
+	out.append(buf, (size_t)bytes);
+}
+inline uint64_t _json_get_be(const unsigned char* p, const int bytes) {
+	uint64_t v = 0;
+	for (int i = 0; i < bytes; ++i) v = (v << 8) | p[i];
+	return v;
+}
+inline uint64_t _json_double_bits(const double d) { uint64_t u; memcpy(&u, &d, 8); return u; }
+inline double _json_bits_double(const uint64_t u) { double d; memcpy(&d, &u, 8); return d; }
+inline uint32_t _json_float_bits(const float f) { uint32_t u; memcpy(&u, &f, 4); return u; }
+inline float _json_bits_float(const uint32_t u) { float f; memcpy(&f, &u, 4); return f; }
+inline bool _json_float_exact(const double d) { return (double)(float)d == d || d != d; } //floatで正確に表せる
+
+//コンテナの空でない要素数
+inline size_t _json_binary_count(json_node<>* n) {
+	size_t count = 0;
+	for (size_t i = 0, size = n->size(); i < size; ++i)
+		if (n->_child(i) != nullptr) ++count;
+	return count;
+}
+
+//CBOR(RFC 8949)の先頭バイトと長さ
+inline void _json_cbor_head(string& out, const int major, const uint64_t v) {
+	unsigned char m = (unsigned char)(major << 5);
+	if (v < 24) out += (char)(m | v);
+	else if (v <= 0xFF) { out += (char)(m | 24); _json_put_be(out, v, 1); }
+	else if (v <= 0xFFFF) { out += (char)(m | 25); _json_put_be(out, v, 2); }
+	else if (v <= 0xFFFFFFFFULL) { out += (char)(m | 26); _json_put_be(out, v, 4); }
+	else { out += (char)(m | 27); _json_put_be(out, v, 8); }
+}
+inline void _json_cbor_encode(json_node<>* n, string& out) {
+	switch (n->type()) {
+		case Object:
+			_json_cbor_head(out, 5, _json_binary_count(n));
+			for (size_t i = 0, size = n->size(); i < size; ++i) {
+				json_node<>* c = n->_child(i);
+				if (c == nullptr) continue;
+				const _json_key* k = n->_child_key(i);
+				_json_cbor_head(out, 3, k->len);
+				out.append(k->data, k->len);
+				_json_cbor_encode(c, out);
+			}
+			break;
+		case Array:
+			_json_cbor_head(out, 4, _json_binary_count(n));
+			for (size_t i = 0, size = n->size(); i < size; ++i)
+				if (json_node<>* c = n->_child(i)) _json_cbor_encode(c, out);
+			break;
+		case String: {
+			json_string_view str = n->get_string_view();
+			_json_cbor_head(out, 3, str.size());
+			out.append(str.data(), str.size());
+			break;
+		}
+		case Number: {
+			//整数はそのまま、浮動小数点数は精度を落とさない範囲で短い形式
+			_json_numval v = n->get_numval();
+			if (v.kind == 'u') _json_cbor_head(out, 0, v.u);
+			else if (v.kind == 'i') {
+				if (v.i >= 0) _json_cbor_head(out, 0, (uint64_t)v.i);
+				else _json_cbor_head(out, 1, (uint64_t)(-1 - v.i));
+			} else if (_json_float_exact(v.d)) { out += (char)0xFA; _json_put_be(out, _json_float_bits((float)v.d), 4); }
+			else { out += (char)0xFB; _json_put_be(out, _json_double_bits(v.d), 8); }
+			break;
+		}
+		case Boolean: out += (char)(n->get_bool() ? 0xF5 : 0xF4); break;
+		default: out += (char)0xF6; break;
+	}
+}
+inline bool _json_cbor_length(const unsigned char* p, const size_t n, size_t& pos, const int info, uint64_t& v) {
+	//追加情報から長さ・値を取得(不定長は呼び出し側で処理)
+	if (info < 24) { v = (uint64_t)info; return true; }
+	if (info > 27) return false;
+	int bytes = 1 << (info - 24);
+	if (pos + bytes > n) return false;
+	v = _json_get_be(p + pos, bytes);
+	pos += bytes;
+	return true;
+}
+inline bool _json_cbor_string(const unsigned char* p, const size_t n, size_t& pos, const int major, const int info, string& out) {
+	//テキスト・バイト列(不定長は分割された断片を連結)
+	if (info == 31) {
+		out.clear();
+		while (pos < n && p[pos] != 0xFF) {
+			int m = p[pos] >> 5, i = p[pos] & 31;
+			++pos;
+			string part;
+			if (m != major || i == 31 || !_json_cbor_string(p, n, pos, major, i, part)) return false;
+			out += part;
+		}
+		if (pos >= n) return false;
+		++pos;
+		return true;
+	}
+	uint64_t len;
+	if (!_json_cbor_length(p, n, pos, info, len) || len > n - pos) return false;
+	out.assign((const char*)p + pos, (size_t)len);
+	pos += (size_t)len;
+	return true;
+}
+inline json_node<>* _json_cbor_decode(const unsigned char* p, const size_t n, size_t& pos, const int depth) {
+	if (pos >= n || depth > _json_binary_max_depth) return nullptr;
+	int major = p[pos] >> 5, info = p[pos] & 31;
+	++pos;
+	uint64_t v;
+	switch (major) {
+		case 0:
+			if (!_json_cbor_length(p, n, pos, info, v)) return nullptr;
+			return new json_number<>(v);
+		case 1:
+			if (!_json_cbor_length(p, n, pos, info, v)) return nullptr;
+			if (v <= (uint64_t)INT64_MAX) return new json_number<>(-1 - (int64_t)v);
+			return new json_number<>(-1.0 - (double)v);
+		case 2: case 3: {
+			string str;
+			if (!_json_cbor_string(p, n, pos, major, info, str)) return nullptr;
+			return new json_string<>(str);
+		}
+		case 4: {
+			json_array<>* a = new json_array<>;
+			if (info == 31) {
+				while (pos < n && p[pos] != 0xFF) {
+					json_node<>* c = _json_cbor_decode(p, n, pos, depth + 1);
+					if (c == nullptr) { delete a; return nullptr; }
+					a->add_array(c);
+				}
+				if (pos >= n) { delete a; return nullptr; }
+				++pos;
+				return a;
+			}
+			//要素数から事前に確保(各要素は1バイト以上)
+			if (!_json_cbor_length(p, n, pos, info, v) || v > n - pos) { delete a; return nullptr; }
+			a->resize((size_t)v);
+			for (size_t i = 0; i < (size_t)v; ++i) {
+				json_node<>* c = _json_cbor_decode(p, n, pos, depth + 1);
+				if (c == nullptr) { delete a; return nullptr; }
+				a->set_array(i, c);
+			}
+			return a;
+		}
+		case 5: {
+			json_object<>* o = new json_object<>;
+			bool indefinite = info == 31;
+			if (!indefinite && (!_json_cbor_length(p, n, pos, info, v) || v > (n - pos) / 2)) { delete o; return nullptr; }
+			if (!indefinite) o->reserve((size_t)v);
+			string key;
+			for (size_t i = 0; indefinite ? pos < n && p[pos] != 0xFF : i < (size_t)v; ++i) {
+				//キーは文字列(整数は10進数の文字列に変換)
+				if (pos >= n) { delete o; return nullptr; }
+				int km = p[pos] >> 5, ki = p[pos] & 31;
+				++pos;
+				if (km == 2 || km == 3) {
+					if (!_json_cbor_string(p, n, pos, km, ki, key)) { delete o; return nullptr; }
+				} else if (km == 0 || km == 1) {
+					uint64_t k;
+					if (!_json_cbor_length(p, n, pos, ki, k)) { delete o; return nullptr; }
+					_json_numval kv;
+					if (km == 0) { kv.kind = 'u'; kv.u = k; }
+					else if (k <= (uint64_t)INT64_MAX) { kv.kind = 'i'; kv.i = -1 - (int64_t)k; }
+					else { delete o; return nullptr; }
+					key = kv.to_string();
+				} else { delete o; return nullptr; }
+				json_node<>* c = _json_cbor_decode(p, n, pos, depth + 1);
+				if (c == nullptr) { delete o; return nullptr; }
+				o->set_object(key, c);
+			}
+			if (indefinite) {
+				if (pos >= n) { delete o; return nullptr; }
+				++pos;
+			}
+			return o;
+		}
+		case 6: //タグは無視して中身を読み込む
+			if (!_json_cbor_length(p, n, pos, info, v)) return nullptr;
+			return _json_cbor_decode(p, n, pos, depth + 1);
+		default:
+			switch (info) {
+				case 20: return new json_boolean<>(false);
+				case 21: return new json_boolean<>(true);
+				case 22: case 23: return new json_null<>();
+				case 25: {
+					//半精度浮動小数点数
+					if (pos + 2 > n) return nullptr;
+					unsigned h = (unsigned)_json_get_be(p + pos, 2);
+					pos += 2;
+					int e = (h >> 10) & 0x1F;
+					double m = h & 0x3FF;
+					double d = e == 0 ? ldexp(m, -24) : e != 31 ? ldexp(m + 1024, e - 25) : m == 0 ? HUGE_VAL : NAN;
+					return new json_number<>(h & 0x8000 ? -d : d);
+				}
+				case 26:
+					if (pos + 4 > n) return nullptr;
+					pos += 4;
+					return new json_number<>((double)_json_bits_float((uint32_t)_json_get_be(p + pos - 4, 4)));
+				case 27:
+					if (pos + 8 > n) return nullptr;
+					pos += 8;
+					return new json_number<>(_json_bits_double(_json_get_be(p + pos - 8, 8)));
+				default: return nullptr;
+			}
+	}
+}
+
+//ノードをCBORに変換
+inline void json_to_cbor(json_node<>* n, string& out) { if (n != nullptr) _json_cbor_encode(n, out); }
+inline string json_to_cbor(json_node<>* n) {
+	string out;
+	json_to_cbor(n, out);
+	return out;
+}
+//CBORからノードを作成(失敗した場合はnullptr)
+inline json_node<>* json_from_cbor(const char* data, const size_t n) {
+	size_t pos = 0;
+	json_node<>* root = _json_cbor_decode((const unsigned char*)data, n, pos, 0);
+	if (root != nullptr && pos != n) { delete root; return nullptr; }
+	return root;
+}
+inline json_node<>* json_from_cbor(const string& data) { return json_from_cbor(data.data(), data.size()); }
+
+//MessagePack
+inline void _json_msgpack_head(string& out, const uint64_t len, const unsigned char fix, const uint64_t fixmax, const unsigned char b8, const unsigned char b16, const unsigned char b32) {
+	//長さ付きの先頭(b8が0の場合は8ビット形式なし)
+	if (len <= fixmax) out += (char)(fix | len);
+	else if (b8 != 0 && len <= 0xFF) { out += (char)b8; _json_put_be(out, len, 1); }
+	else if (len <= 0xFFFF) { out += (char)b16; _json_put_be(out, len, 2); }
+	else { out += (char)b32; _json_put_be(out, len, 4); }
+}
+inline void _json_msgpack_encode(json_node<>* n, string& out) {
+	switch (n->type()) {
+		case Object:
+			_json_msgpack_head(out, _json_binary_count(n), 0x80, 15, 0, 0xDE, 0xDF);
+			for (size_t i = 0, size = n->size(); i < size; ++i) {
+				json_node<>* c = n->_child(i);
+				if (c == nullptr) continue;
+				const _json_key* k = n->_child_key(i);
+				_json_msgpack_head(out, k->len, 0xA0, 31, 0xD9, 0xDA, 0xDB);
+				out.append(k->data, k->len);
+				_json_msgpack_encode(c, out);
+			}
+			break;
+		case Array:
+			_json_msgpack_head(out, _json_binary_count(n), 0x90, 15, 0, 0xDC, 0xDD);
+			for (size_t i = 0, size = n->size(); i < size; ++i)
+				if (json_node<>* c = n->_child(i)) _json_msgpack_encode(c, out);
+			break;
+		case String: {
+			json_string_view str = n->get_string_view();
+			_json_msgpack_head(out, str.size(), 0xA0, 31, 0xD9, 0xDA, 0xDB);
+			out.append(str.data(), str.size());
+			break;
+		}
+		case Number: {
+			_json_numval v = n->get_numval();
+			if (v.kind == 'u' || (v.kind == 'i' && v.i >= 0)) {
+				uint64_t u = v.kind == 'u' ? v.u : (uint64_t)v.i;
+				if (u < 0x80) out += (char)u;
+				else if (u <= 0xFF) { out += (char)0xCC; _json_put_be(out, u, 1); }
+				else if (u <= 0xFFFF) { out += (char)0xCD; _json_put_be(out, u, 2); }
+				else if (u <= 0xFFFFFFFFULL) { out += (char)0xCE; _json_put_be(out, u, 4); }
+				else { out += (char)0xCF; _json_put_be(out, u, 8); }
+			} else if (v.kind == 'i') {
+				if (v.i >= -32) out += (char)(int8_t)v.i;
+				else if (v.i >= INT8_MIN) { out += (char)0xD0; _json_put_be(out, (uint64_t)v.i, 1); }
+				else if (v.i >= INT16_MIN) { out += (char)0xD1; _json_put_be(out, (uint64_t)v.i, 2); }
+				else if (v.i >= INT32_MIN) { out += (char)0xD2; _json_put_be(out, (uint64_t)v.i, 4); }
+				else { out += (char)0xD3; _json_put_be(out, (uint64_t)v.i, 8); }
+			} else if (_json_float_exact(v.d)) { out += (char)0xCA; _json_put_be(out, _json_float_bits((float)v.d), 4); }
+			else { out += (char)0xCB; _json_put_be(out, _json_double_bits(v.d), 8); }
+			break;
+		}
+		case Boolean: out += (char)(n->get_bool() ? 0xC3 : 0xC2); break;
+		default: out += (char)0xC0; break;
+	}
+}
+inline bool _json_msgpack_string(const unsigned char* p, const size_t n, size_t& pos, string& out) {
+	//文字列・バイナリ
+	if (pos >= n) return false;
+	unsigned char c = p[pos++];
+	uint64_t len;
+	if ((c & 0xE0) == 0xA0) len = c & 0x1F;
+	else if (c == 0xD9 || c == 0xC4) { if (pos + 1 > n) return false; len = p[pos]; pos += 1; }
+	else if (c == 0xDA || c == 0xC5) { if (pos + 2 > n) return false; len = _json_get_be(p + pos, 2); pos += 2; }
+	else if (c == 0xDB || c == 0xC6) { if (pos + 4 > n) return false; len = _json_get_be(p + pos, 4); pos += 4; }
+	else return false;
+	if (len > n - pos) return false;
+	out.assign((const char*)p + pos, (size_t)len);
+	pos += (size_t)len;
+	return true;
+}
+inline json_node<>* _json_msgpack_decode(const unsigned char* p, const size_t n, size_t& pos, const int depth) {
+	if (pos >= n || depth > _json_binary_max_depth) return nullptr;
+	unsigned char c = p[pos];
+	if (c < 0x80) { ++pos; return new json_number<>((int64_t)c); }
+	if (c >= 0xE0) { ++pos; return new json_number<>((int64_t)(int8_t)c); }
+	if ((c & 0xE0) == 0xA0 || c == 0xD9 || c == 0xDA || c == 0xDB || c == 0xC4 || c == 0xC5 || c == 0xC6) {
+		string str;
+		if (!_json_msgpack_string(p, n, pos, str)) return nullptr;
+		return new json_string<>(str);
+	}
+	++pos;
+	uint64_t count;
+	bool array;
+	if ((c & 0xF0) == 0x90 || (c & 0xF0) == 0x80) { array = (c & 0xF0) == 0x90; count = c & 0x0F; }
+	else if (c == 0xDC || c == 0xDE) { if (pos + 2 > n) return nullptr; array = c == 0xDC; count = _json_get_be(p + pos, 2); pos += 2; }
+	else if (c == 0xDD || c == 0xDF) { if (pos + 4 > n) return nullptr; array = c == 0xDD; count = _json_get_be(p + pos, 4); pos += 4; }
+	else {
+		//スカラー値
+		static const unsigned char sizes[] = { 1, 2, 4, 8 };
+		int bytes = 0;
+		if (c >= 0xCA && c <= 0xD3) bytes = c == 0xCA ? 4 : c == 0xCB ? 8 : sizes[(c - 0xCC) & 3];
+		if (pos + bytes > n) return nullptr;
+		uint64_t v = _json_get_be(p + pos, bytes);
+		pos += bytes;
+		switch (c) {
+			case 0xC0: return new json_null<>();
+			case 0xC2: return new json_boolean<>(false);
+			case 0xC3: return new json_boolean<>(true);
+			case 0xCA: return new json_number<>((double)_json_bits_float((uint32_t)v));
+			case 0xCB: return new json_number<>(_json_bits_double(v));
+			case 0xCC: case 0xCD: case 0xCE: case 0xCF: return new json_number<>(v);
+			case 0xD0: return new json_number<>((int64_t)(int8_t)v);
+			case 0xD1: return new json_number<>((int64_t)(int16_t)v);
+			case 0xD2: return new json_number<>((int64_t)(int32_t)v);
+			case 0xD3: return new json_number<>((int64_t)v);
+			default: return nullptr; //拡張型は未対応
+		}
+	}
+	if (array) {
+		//要素数から事前に確保(各要素は1バイト以上)
+		if (count > n - pos) return nullptr;
+		json_array<>* a = new json_array<>((size_t)count);
+		for (size_t i = 0; i < (size_t)count; ++i) {
+			json_node<>* e = _json_msgpack_decode(p, n, pos, depth + 1);
+			if (e == nullptr) { delete a; return nullptr; }
+			a->set_array(i, e);
+		}
+		return a;
+	}
+	if (count > (n - pos) / 2) return nullptr;
+	json_object<>* o = new json_object<>;
+	o->reserve((size_t)count);
+	string key;
+	for (size_t i = 0; i < (size_t)count; ++i) {
+		json_node<>* k = nullptr;
+		if (pos < n && ((p[pos] & 0xE0) == 0xA0 || (p[pos] >= 0xD9 && p[pos] <= 0xDB) || (p[pos] >= 0xC4 && p[pos] <= 0xC6))) {
+			if (!_json_msgpack_string(p, n, pos, key)) { delete o; return nullptr; }
+		} else {
+			//整数のキーは10進数の文字列に変換
+			k = _json_msgpack_decode(p, n, pos, depth + 1);
+			if (k == nullptr || k->type() != Number || k->get_numval().kind == 'd') { delete k; delete o; return nullptr; }
+			key = k->get_string();
+			delete k;
+		}
+		json_node<>* e = _json_msgpack_decode(p, n, pos, depth + 1);
+		if (e == nullptr) { delete o; return nullptr; }
+		o->set_object(key, e);
+	}
+	return o;
+}
+
+//ノードをMessagePackに変換
+inline void json_to_msgpack(json_node<>* n, string& out) { if (n != nullptr) _json_msgpack_encode(n, out); }
+inline string json_to_msgpack(json_node<>* n) {
+	string out;
+	json_to_msgpack(n, out);
+	return out;
+}
+//MessagePackからノードを作成(失敗した場合はnullptr)
+inline json_node<>* json_from_msgpack(const char* data, const size_t n) {
+	size_t pos = 0;
+	json_node<>* root = _json_msgpack_decode((const unsigned char*)data, n, pos, 0);
+	if (root != nullptr && pos != n) { delete root; return nullptr; }
+	return root;
+}
+inline json_node<>* json_from_msgpack(const string& data) { return json_from_msgpack(data.data(), data.size()); }
+
+class json_tape;
+
+//テープ上の値を参照するビュー(読み込み専用)
+class json_tape_view {
+	const json_tape* v_tape;
+	size_t v_pos;
+public:
+	json_tape_view() : v_tape(nullptr), v_pos(0) {}
+	json_tape_view(const json_tape* t, const size_t pos) : v_tape(t), v_pos(pos) {}
+	bool valid() const { return v_tape != nullptr; }
+	explicit operator bool() const { return v_tape != nullptr; }
+	size_t position() const { return v_pos; }
+	inline json_type type() const;
+	inline size_t next() const;
+	inline json_tape_view get_object(const string& key) const;
+	inline json_tape_view get_array(const size_t num) const;
+	inline string get_string() const;
+	inline const char* string_data() const;
+	inline size_t string_size() const;
+	inline double get_number() const;
+	inline int64_t get_int() const;
+	inline uint64_t get_uint() const;
+	inline _json_numval get_numval() const;
+	inline bool get_bool() const;
+	inline size_t size() const;
+	inline json_node<>* to_node(_json_arena* arena = nullptr) const;
+
+	json_tape_view operator[](const string& str) const { return get_object(str); }
+	json_tape_view operator[](const size_t num) const { return get_array(num); }
+};
+
+//連続領域に書き込む読み込み専用のテープ形式
+//1ワード64bit: 上位8bitが型タグ、下位56bitがペイロード
+//  '{' '[' : 下位32bit=対応する終端ワードの次の位置, 上位24bit=要素数
+//  '}' ']' : 対応する開始ワードの位置
+//  '"'     : 文字列バッファ上の位置(先頭4byteに長さ)
+//  'd' 'i' 'u' : 次のワードにdouble, int64, uint64のビット列
+//  't' 'f' 'n' : true, false, null
+class json_tape {
+	vector<uint64_t> t_tape;
+	string t_strings;
+	size_t t_max_depth;
+	friend class json_tape_view;
+
+	static uint64_t word(const char tag, const uint64_t payload) { return ((uint64_t)(unsigned char)tag << 56) | (payload & 0x00FFFFFFFFFFFFFFULL); }
+	bool set_container(const size_t start, const char tag, const size_t cnt) {
+		//終端の位置は32bitで保持(超える場合は失敗)
+		size_t end = t_tape.size();
+		if (end + 1 > (size_t)UINT32_MAX) return false;
+		t_tape.push_back(word(tag == '{' ? '}' : ']', start));
+		t_tape[start] = word(tag, ((uint64_t)min(cnt, (size_t)0xFFFFFF) << 32) | (uint32_t)(end + 1));
+		return true;
+	}
+	void add_string(const string& str) {
+		t_tape.push_back(word('\"', t_strings.size()));
+		uint32_t len = (uint32_t)str.size();
+		t_strings.append((const char*)&len, sizeof(len));
+		t_strings.append(str);
+		t_strings += '\0';
+	}
+	bool parse_index(const string& json, size_t pos, string& e_temp) {
+		//構造インデックスの位置を順にたどってテープを作成
+		vector<uint32_t> index;
+		if (!json_structural_index(json.data() + pos, json.size() - pos, index)) return false;
+		struct frame { size_t start; size_t cnt; char tag; };
+		vector<frame> stack;
+		const char* p = json.data();
+		const size_t base = pos, n = json.size();
+		int state = 0; //0=値, 1=キーまたは'}', 2=':', 3=','または終端, 4=キー, 5=値または']'
+		_json_numval num;
+		for (size_t k = 0; k < index.size(); ++k) {
+			pos = base + index[k];
+			const size_t next = k + 1 < index.size() ? base + index[k+1] : n;
+			const char c = p[pos];
+			switch (state) {
+				case 2:
+					if (c != ':') return false;
+					state = 0;
+					continue;
+				case 3:
+					if (c == ',') { state = stack.back().tag == '{' ? 4 : 0; continue; }
+					if (c != (stack.back().tag == '{' ? '}' : ']')) return false;
+					break;
+				case 1: case 4:
+					if (c == '}' && state == 1) break;
+					if (c != '\"') return false;
+					++pos;
+					add_string(_json_escape_decode(json, pos, e_temp));
+					if (_json_skip_ws(p, pos, n) != next) return false;
+					state = 2;
+					continue;
+				case 5:
+					if (c == ']') break;
+				default:
+					switch (c) {
+						case '{': case '[':
+							if (stack.size() >= t_max_depth) return false;
+							stack.push_back({ t_tape.size(), 0, c });
+							t_tape.push_back(0);
+							state = c == '{' ? 1 : 5;
+							continue;
+						case '\"': //string
+							++pos;
+							add_string(_json_escape_decode(json, pos, e_temp));
+							break;
+						case '-':
+						case '0': case '1': case '2': case '3': case '4':
+						case '5': case '6': case '7': case '8': case '9':
+							//number
+							if (!_json_parse_number(json, pos, num)) return false;
+							t_tape.push_back(word(num.kind, 0));
+							t_tape.push_back(0);
+							memcpy(&t_tape.back(), &num.d, sizeof(num.d));
+							break;
+						case 't': //boolean true
+							if (json.compare(pos+1, 3, "rue") != 0) return false;
+							pos += 4;
+							t_tape.push_back(word('t', 0));
+							break;
+						case 'f': //boolean false
+							if (json.compare(pos+1, 4, "alse") != 0) return false;
+							pos += 5;
+							t_tape.push_back(word('f', 0));
+							break;
+						case 'n': //null
+							if (json.compare(pos+1, 3, "ull") != 0) return false;
+							pos += 4;
+							t_tape.push_back(word('n', 0));
+							break;
+						default: return false;
+					}
+					//値の後は空白のみで次の構造文字に続く
+					if (_json_skip_ws(p, pos, n) != next) return false;
+					if (stack.empty()) return true;
+					++stack.back().cnt;
+					state = 3;
+					continue;
+			}
+			//コンテナの終了
+			if (!set_container(stack.back().start, stack.back().tag, stack.back().cnt)) return false;
+			stack.pop_back();
+			if (stack.empty()) return true;
+			++stack.back().cnt;
+			state = 3;
+		}
+		return false;
+	}
+	char tag(const size_t pos) const { return (char)(t_tape[pos] >> 56); }
+	uint64_t payload(const size_t pos) const { return t_tape[pos] & 0x00FFFFFFFFFFFFFFULL; }
+public:
+	json_tape(const size_t max_depth = json_default_max_depth) : t_max_depth(max_depth) {}
+	//入れ子の深さの上限(超えた場合は読み込みに失敗)
+	void set_max_depth(const size_t depth) { t_max_depth = depth; }
+	bool parse(const string& json) {
+		//読み込みに失敗した場合は空のテープになる
+		clear();
+		t_tape.reserve(json.size() / 8 + 16);
+		t_strings.reserve(json.size() / 2 + 16);
+		size_t pos = _json_skip_bom(json.data(), json.size());
+		string e_temp;
+		if (!parse_index(json, pos, e_temp)) { clear(); return false; }
+		return true;
+	}
+	void clear() { t_tape.clear(); t_strings.clear(); }
+	bool empty() const { return t_tape.empty(); }
+	size_t tape_size() const { return t_tape.size(); }
+	json_tape_view root() const { return t_tape.empty() ? json_tape_view() : json_tape_view(this, 0); }
+};
+
+json_type json_tape_view::type() const {
+	if (v_tape == nullptr) return None;
+	switch (v_tape->tag(v_pos)) {
+		case '{': return Object;
+		case '[': return Array;
+		case '\"': return String;
+		case 'd': case 'i': case 'u': return Number;
+		case 't': case 'f': return Boolean;
+		case 'n': return Null;
+		default: return None;
+	}
+}
+size_t json_tape_view::next() const {
+	//値の次の位置(コンテナは終端ワードの位置からO(1)でスキップ)
+	switch (v_tape->tag(v_pos)) {
+		case '{': case '[': return (uint32_t)v_tape->payload(v_pos);
+		case 'd': case 'i': case 'u': return v_pos + 2;
+		default: return v_pos + 1;
+	}
+}
+json_tape_view json_tape_view::get_object(const string& key) const {
+	if (type() != Object) return json_tape_view();
+	size_t end = next() - 1;
+	for (size_t p = v_pos + 1; p < end; ) {
+		json_tape_view k(v_tape, p), v(v_tape, p + 1);
+		if (k.string_size() == key.size() && memcmp(k.string_data(), key.data(), key.size()) == 0) return v;
+		p = v.next();
+	}
+	return json_tape_view();
+}
+json_tape_view json_tape_view::get_array(const size_t num) const {
+	if (type() != Array) return json_tape_view();
+	size_t end = next() - 1, p = v_pos + 1;
+	for (size_t i = 0; p < end; ++i) {
+		if (i == num) return json_tape_view(v_tape, p);
+		p = json_tape_view(v_tape, p).next();
+	}
+	return json_tape_view();
+}
+const char* json_tape_view::string_data() const {
+	if (type() != String) return "";
+	return v_tape->t_strings.data() + v_tape->payload(v_pos) + sizeof(uint32_t);
+}
+size_t json_tape_view::string_size() const {
+	if (type() != String) return 0;
+	uint32_t len;
+	memcpy(&len, v_tape->t_strings.data() + v_tape->payload(v_pos), sizeof(len));
+	return len;
+}
+string json_tape_view::get_string() const {
+	switch (type()) {
+		case String: return string(string_data(), string_size());
+		case Number: return get_numval().to_string();
+		case Boolean: return get_bool() ? "true" : "false";
+		default: return "";
+	}
+}
+double json_tape_view::get_number() const {
+	switch (type()) {
+		case Number: return get_numval().to_double();
+		case String: return stod(get_string());
+		case Boolean: return get_bool() ? 1 : 0;
+		default: return 0;
+	}
+}
+_json_numval json_tape_view::get_numval() const {
+	_json_numval num;
+	if (type() != Number) num.d = get_number();
+	else {
+		num.kind = v_tape->tag(v_pos);
+		memcpy(&num.d, &v_tape->t_tape[v_pos + 1], sizeof(num.d));
+	}
+	return num;
+}
+int64_t json_tape_view::get_int() const { return get_numval().clamp_int(); }
+uint64_t json_tape_view::get_uint() const { return get_numval().clamp_uint(); }
+bool json_tape_view::get_bool() const {
+	switch (type()) {
+		case Boolean: return v_tape->tag(v_pos) == 't';
+		case Number: return get_number() != 0;
+		default: return false;
+	}
+}
+size_t json_tape_view::size() const {
+	json_type t = type();
+	if (t != Object && t != Array) return 0;
+	size_t cnt = (size_t)(v_tape->payload(v_pos) >> 32);
+	if (cnt < 0xFFFFFF) return cnt;
+	//要素数が上限を超えた場合は数え直す
+	cnt = 0;
+	size_t end = next() - 1;
+	for (size_t p = v_pos + 1; p < end; ++cnt) p = json_tape_view(v_tape, t == Object ? p + 1 : p).next();
+	return cnt;
+}
+json_node<>* json_tape_view::to_node(_json_arena* arena) const {
+	//編集可能なノードに変換
+	json_node<>* node;
+	size_t end, p;
+	switch (type()) {
+		case Object:
+			node = _json_new<json_object<>>(arena);
+			node->reserve(size());
+			end = next() - 1;
+			for (p = v_pos + 1; p < end; ) {
+				json_tape_view k(v_tape, p), v(v_tape, p + 1);
+				node->set_object(k.string_data(), k.string_size(), v.to_node(arena));
+				p = v.next();
+			}
+			return node;
+		case Array:
+			node = _json_new<json_array<>>(arena);
+			node->reserve(size());
+			end = next() - 1;
+			for (p = v_pos + 1; p < end; ) {
+				json_tape_view v(v_tape, p);
+				node->add_array(v.to_node(arena));
+				p = v.next();
+			}
+			return node;
+		case String: return _json_new<json_string<>>(arena, string_data(), string_size());
+		case Number: return _json_new<json_number<>>(arena, get_numval());
+		case Boolean: return _json_new<json_boolean<>>(arena, get_bool());
+		case Null: return _json_new<json_null<>>(arena);
+		default: return nullptr;
+	}
+}
+
 #endif //_JSON_HPP